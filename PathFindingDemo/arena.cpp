@@ -0,0 +1,72 @@
+#include <new>
+#include <cstdint>
+
+#include "arena.h"
+
+namespace game {
+
+Arena::Arena(size_t block_size){
+
+    block_size_ = block_size;
+    next_ = NULL;
+    end_ = NULL;
+    capacity_ = 0;
+}
+
+
+Arena::~Arena(){
+
+    Clear();
+}
+
+
+void Arena::AddBlock(size_t size){
+
+    // Allocate at least a full block, so that small allocations are
+    // grouped together
+    if (size < block_size_){
+        size = block_size_;
+    }
+    char *block = static_cast<char*>(::operator new(size));
+    block_.push_back(block);
+    next_ = block;
+    end_ = block + size;
+    capacity_ += size;
+}
+
+
+void Arena::Reserve(size_t size){
+
+    // Leave room for aligning the first allocation
+    if ((size_t) (end_ - next_) < size + alignof(std::max_align_t)){
+        AddBlock(size + alignof(std::max_align_t));
+    }
+}
+
+
+void *Arena::Allocate(size_t size, size_t alignment){
+
+    // Round the next free byte up to the alignment, and start a new
+    // block if the memory does not fit in the current one
+    uintptr_t p = (reinterpret_cast<uintptr_t>(next_) + alignment - 1) & ~(uintptr_t) (alignment - 1);
+    if (next_ == NULL || p + size > reinterpret_cast<uintptr_t>(end_)){
+        AddBlock(size + alignment);
+        p = (reinterpret_cast<uintptr_t>(next_) + alignment - 1) & ~(uintptr_t) (alignment - 1);
+    }
+    next_ = reinterpret_cast<char*>(p + size);
+    return reinterpret_cast<void*>(p);
+}
+
+
+void Arena::Clear(void){
+
+    for (size_t i = 0; i < block_.size(); i++){
+        ::operator delete(block_[i]);
+    }
+    block_.clear();
+    next_ = NULL;
+    end_ = NULL;
+    capacity_ = 0;
+}
+
+} // namespace game
@@ -0,0 +1,67 @@
+#ifndef ARENA_H_
+#define ARENA_H_
+
+#include <vector>
+#include <cstddef>
+
+namespace game {
+
+// Memory arena that hands out memory from large blocks
+//
+// Allocating only moves a pointer forward in the current block, and
+// memory is never returned individually: all of it is released at once
+// by Clear() or the destructor. Objects created in the arena must
+// therefore not need their destructor to run. Memory never moves, so
+// pointers to allocated objects stay valid until the arena is cleared
+class Arena {
+
+    public:
+        // Create an empty arena that allocates blocks of at least the
+        // given size in bytes
+        Arena(size_t block_size = 64*1024);
+
+        // Release all blocks
+        ~Arena();
+
+        // Make sure that the given number of bytes can be allocated
+        // without allocating another block
+        void Reserve(size_t size);
+
+        // Allocate memory for size bytes with the given alignment
+        void *Allocate(size_t size, size_t alignment);
+
+        // Allocate uninitialized memory for count objects of type T
+        template <class T>
+        inline T *Allocate(int count) { return static_cast<T*>(Allocate(count*sizeof(T), alignof(T))); }
+
+        // Release all blocks, invalidating everything allocated so far
+        void Clear(void);
+
+        // Get the number of bytes taken by the blocks
+        inline size_t GetCapacity(void) const { return capacity_; }
+
+        // An arena owns its blocks, so it cannot be copied
+        Arena(const Arena &) = delete;
+        Arena &operator=(const Arena &) = delete;
+
+    private:
+        // Minimum size of a block
+        size_t block_size_;
+
+        // All blocks allocated so far, the current one last
+        std::vector<char*> block_;
+
+        // Next free byte and end of the current block
+        char *next_;
+        char *end_;
+
+        // Total size of the blocks
+        size_t capacity_;
+
+        // Allocate a new block with room for at least size bytes
+        void AddBlock(size_t size);
+};
+
+} // namespace game
+
+#endif // ARENA_H_
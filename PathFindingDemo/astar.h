@@ -0,0 +1,84 @@
+#ifndef ASTAR_H_
+#define ASTAR_H_
+
+#include <cstdint>
+
+#include "search_context.h"
+#include "heuristic.h"
+
+namespace game {
+
+// A* search from start until the end node is expanded
+//
+// Nodes are ranked by the cost to reach them plus the heuristic
+// estimate of the cost left to the end node, so the search expands
+// towards the end instead of in all directions. With an admissible and
+// consistent heuristic (see Heuristic::ForGraph) the path has the same
+// cost as the one found by Dijkstra's algorithm
+//
+// The graph type needs to provide the compact-graph interface and node
+// positions, and the queue type is one of the policies in
+// search_queue.h. Costs and links stored in the context are the real
+// path costs, without the estimate. Returns false if the end node
+// cannot be reached
+template <typename GraphType, typename QueueType>
+bool AStar(const GraphType &graph, int start, int end, const Heuristic &heuristic, QueueType &queue, SearchContext &context){
+
+    // Reset the search state and the queue
+    context.Reset(graph.GetNumNodes());
+    queue.Clear(graph.GetNumNodes());
+    SearchStats &stats = context.GetStats();
+
+    // Position of the end node, used for all estimates
+    float end_x = graph.GetX(end);
+    float end_y = graph.GetY(end);
+
+    // The start node is added to the queue with its estimate
+    context.SetCost(start, 0.0);
+    queue.Push(start, heuristic.Estimate(graph.GetX(start), graph.GetY(start), end_x, end_y));
+    stats.pushes++;
+
+    while (!queue.Empty()) {
+        // Remove the node with the lowest estimated total cost
+        int node;
+        float key;
+        queue.Pop(node, key);
+        stats.pops++;
+
+        // Skip zombie entries of nodes that were already expanded
+        if (context.IsVisited(node)) {
+            stats.stale_pops++;
+            continue;
+        }
+        context.SetVisited(node, true);
+        stats.expanded++;
+
+        // If the current node is the end node, we are done
+        if (node == end) {
+            return true;
+        }
+
+        // Otherwise, relax the edges to the neighbors of the node
+        float cost = context.GetCost(node);
+        uint32_t edge_end = graph.EdgeEnd(node);
+        for (uint32_t e = graph.EdgeBegin(node); e < edge_end; e++){
+            int n = graph.GetTarget(e);
+            float node_cost = cost + graph.GetCost(e);
+
+            // If the new cost is smaller than the current node cost,
+            // update the node and rank it by its estimated total cost
+            if (node_cost < context.GetCost(n)){
+                context.SetCost(n, node_cost);
+                context.SetPrev(n, node);
+                queue.Push(n, node_cost + heuristic.Estimate(graph.GetX(n), graph.GetY(n), end_x, end_y));
+                stats.pushes++;
+            }
+        }
+    }
+
+    return false;
+}
+
+} // namespace game
+
+#endif // ASTAR_H_
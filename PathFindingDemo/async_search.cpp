@@ -0,0 +1,69 @@
+#include <exception>
+
+#include "async_search.h"
+
+namespace game {
+
+AsyncSearch::AsyncSearch(void){
+
+    stop_ = false;
+    thread_ = std::thread(&AsyncSearch::Work, this);
+}
+
+
+AsyncSearch::~AsyncSearch(){
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_one();
+    thread_.join();
+}
+
+
+std::future<PathResult> AsyncSearch::Push(int start, int end, const SearchFunction &search){
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.push_back(Request());
+    Request &request = queue_.back();
+    request.start = start;
+    request.end = end;
+    request.search = search;
+    std::future<PathResult> future = request.result.get_future();
+    wake_.notify_one();
+    return future;
+}
+
+
+void AsyncSearch::Work(void){
+
+    while (true){
+        // Wait for a query, or exit once all queries are done
+        Request request;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this]{ return stop_ || !queue_.empty(); });
+            if (queue_.empty()){
+                return;
+            }
+            request = std::move(queue_.front());
+            queue_.pop_front();
+        }
+
+        // Run the search without holding the lock, and pass any error
+        // on to the owner of the future
+        PathResult result;
+        result.start = request.start;
+        result.end = request.end;
+        result.cost = 0.0f;
+        try {
+            result.found = request.search(request.start, request.end, context_, result.path, &result.cost);
+            request.result.set_value(std::move(result));
+        } catch (...) {
+            request.result.set_exception(std::current_exception());
+        }
+    }
+}
+
+} // namespace game
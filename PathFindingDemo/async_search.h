@@ -0,0 +1,99 @@
+#ifndef ASYNC_SEARCH_H_
+#define ASYNC_SEARCH_H_
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <functional>
+
+#include "search_context.h"
+
+namespace game {
+
+// Result of a path query
+struct PathResult {
+    int start; // Index of the start node
+    int end; // Index of the end node
+    bool found; // Flag indicating that there is a path
+    float cost; // Cost of the path, if found
+    std::vector<int> path; // Node indices on the path, from start to end
+};
+
+
+// Runs path queries on a background thread
+//
+// Submitting a query returns at once with a future that receives the
+// result when the search is done, so the caller never waits for a
+// search unless it asks for the result early. Queries run one at a
+// time in the order they were submitted, with a search context owned by
+// the background thread. The graph must not be changed or destroyed
+// while it has queries in flight
+class AsyncSearch {
+
+    public:
+        // Start the background thread
+        AsyncSearch(void);
+
+        // Finish the queries in flight and stop the thread
+        ~AsyncSearch();
+
+        // Queue a query for a path between nodes start and end
+        // The graph type needs to provide the FindPath method used by
+        // BatchSearch
+        template <typename GraphType>
+        std::future<PathResult> Submit(const GraphType &graph, int start, int end){
+            return Push(start, end, [&graph](int start, int end, SearchContext &context, std::vector<int> &path, float *cost){
+                return graph.FindPath(start, end, context, path, cost);
+            });
+        }
+
+        // Queue a query run by the given function, which is called on
+        // the background thread with the same arguments as FindPath
+        template <typename Function>
+        std::future<PathResult> Submit(int start, int end, Function search){
+            return Push(start, end, search);
+        }
+
+        // An object that owns a thread cannot be copied
+        AsyncSearch(const AsyncSearch &) = delete;
+        AsyncSearch &operator=(const AsyncSearch &) = delete;
+
+    private:
+        // Function running one search
+        typedef std::function<bool(int, int, SearchContext &, std::vector<int> &, float *)> SearchFunction;
+
+        // Query waiting for the background thread
+        struct Request {
+            int start;
+            int end;
+            SearchFunction search;
+            std::promise<PathResult> result;
+        };
+
+        // Background thread
+        std::thread thread_;
+
+        // Queries not started yet, protected by mutex_
+        std::mutex mutex_;
+        std::condition_variable wake_;
+        std::deque<Request> queue_;
+
+        // Flag telling the thread to exit once the queue is empty
+        bool stop_;
+
+        // Search state of the background thread
+        SearchContext context_;
+
+        // Add a query to the queue
+        std::future<PathResult> Push(int start, int end, const SearchFunction &search);
+
+        // Main loop of the background thread
+        void Work(void);
+};
+
+} // namespace game
+
+#endif // ASYNC_SEARCH_H_
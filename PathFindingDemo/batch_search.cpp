@@ -0,0 +1,13 @@
+#include "batch_search.h"
+
+namespace game {
+
+BatchSearch::BatchSearch(int num_threads) : pool_(num_threads) {
+
+    // One search context and path buffer per worker
+    for (int i = 0; i < pool_.GetNumThreads(); i++){
+        worker_.push_back(std::unique_ptr<Worker>(new Worker()));
+    }
+}
+
+} // namespace game
@@ -0,0 +1,76 @@
+#ifndef BATCH_SEARCH_H_
+#define BATCH_SEARCH_H_
+
+#include <vector>
+#include <memory>
+#include <cmath>
+
+#include "search_context.h"
+#include "thread_pool.h"
+
+namespace game {
+
+// Endpoints of a path query
+struct PathQuery {
+    int start; // Index of the start node
+    int end; // Index of the end node
+};
+
+
+// Runs many path queries at once on a pool of worker threads
+//
+// Each worker keeps its own search context, so the graph is only read
+// and the queries run fully in parallel. The contexts are kept between
+// batches, so a batch allocates no search state once the workers have
+// seen a graph of the same size
+class BatchSearch {
+
+    public:
+        // Start the given number of workers, or one per hardware thread
+        // if num_threads is 0
+        BatchSearch(int num_threads = 0);
+
+        // Get the number of worker threads
+        inline int GetNumThreads(void) const { return pool_.GetNumThreads(); }
+
+        // Answer num_queries queries on the graph
+        //
+        // The cost of the path of query i is stored in costs[i], or
+        // INFINITY if there is no path. If paths is not NULL, paths[i]
+        // receives the node indices on the path, and is empty if there
+        // is no path. The graph type needs to provide
+        //     bool FindPath(int start, int end, SearchContext &context,
+        //                   std::vector<int> &path, float *cost) const
+        // like Graph (which has to be compiled) and GridGraph
+        template <typename GraphType>
+        void FindPaths(const GraphType &graph, const PathQuery *queries, int num_queries, std::vector<int> *paths, float *costs){
+
+            pool_.Run(num_queries, [&](int i, int thread){
+                // Use the path buffer of the caller, or a buffer of the
+                // worker if the caller only wants the costs
+                Worker &worker = *worker_[thread];
+                std::vector<int> &path = paths != NULL ? paths[i] : worker.path;
+                if (!graph.FindPath(queries[i].start, queries[i].end, worker.context, path, &costs[i])){
+                    costs[i] = INFINITY;
+                }
+            });
+        }
+
+    private:
+        // Worker threads
+        ThreadPool pool_;
+
+        // State of a worker
+        struct Worker {
+            SearchContext context; // Search state
+            std::vector<int> path; // Path buffer for queries that only need the cost
+        };
+
+        // State of each worker, allocated separately so that the workers
+        // do not write to the same cache lines
+        std::vector<std::unique_ptr<Worker> > worker_;
+};
+
+} // namespace game
+
+#endif // BATCH_SEARCH_H_
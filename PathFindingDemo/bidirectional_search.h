@@ -0,0 +1,152 @@
+#ifndef BIDIRECTIONAL_SEARCH_H_
+#define BIDIRECTIONAL_SEARCH_H_
+
+#include <cstdint>
+#include <cmath>
+#include <vector>
+
+#include "search_context.h"
+#include "heuristic.h"
+
+namespace game {
+
+// Bidirectional A* search between start and end
+//
+// One search grows forward from start and another grows backward from
+// end, and the shortest path is found where the two meet. Since the
+// edges of the graph are symmetric (Node::AddNeighbor adds both
+// directions), the backward search uses the same edges as the forward
+// one
+//
+// To guide both searches with the heuristic without losing optimality,
+// each node gets the potential p(v) = (h(v, end) - h(start, v)) / 2. The
+// forward search ranks nodes by cost + p(v) and the backward one by
+// cost - p(v), which keeps the reduced edge costs of both directions
+// non-negative. With these keys, the searches can stop as soon as the
+// sum of the lowest keys of both queues is no smaller than the cost of
+// the best path seen so far. With HEURISTIC_ZERO this is bidirectional
+// Dijkstra's algorithm
+//
+// The forward state is kept in the given context and the backward one
+// in context.GetReverse(). The queue type needs to support PeekKey. On
+// success, path holds the node indices from start to end and cost the
+// path cost. Returns false if the end node cannot be reached
+template <typename GraphType, typename QueueType>
+bool BidirectionalSearch(const GraphType &graph, int start, int end, const Heuristic &heuristic, QueueType &forward_queue, QueueType &backward_queue, SearchContext &context, std::vector<int> &path, float &cost){
+
+    // Reset the state and the queues of both directions
+    SearchContext &forward = context;
+    SearchContext &backward = context.GetReverse();
+    forward.Reset(graph.GetNumNodes());
+    backward.Reset(graph.GetNumNodes());
+    forward_queue.Clear(graph.GetNumNodes());
+    backward_queue.Clear(graph.GetNumNodes());
+    SearchStats &stats = forward.GetStats();
+    path.clear();
+
+    // Positions of the endpoints, used for the potentials
+    float start_x = graph.GetX(start);
+    float start_y = graph.GetY(start);
+    float end_x = graph.GetX(end);
+    float end_y = graph.GetY(end);
+
+    // Start both searches
+    // The potential of start is h(start, end) / 2 and the one of end is
+    // -h(start, end) / 2, so both get the same key
+    float half_estimate = 0.5f*heuristic.Estimate(start_x, start_y, end_x, end_y);
+    forward.SetCost(start, 0.0);
+    backward.SetCost(end, 0.0);
+    forward_queue.Push(start, half_estimate);
+    backward_queue.Push(end, half_estimate);
+    stats.pushes += 2;
+
+    // Cost of the best path seen so far, and the edge where the two
+    // searches met on that path
+    float best = INFINITY;
+    int meet_forward = -1;
+    int meet_backward = -1;
+    if (start == end){
+        best = 0.0;
+        meet_forward = meet_backward = start;
+    }
+
+    // Expand the side with the lowest key until no better path can
+    // exist. If one of the queues runs empty, its side has reached every
+    // node it can, and the best path has already been seen
+    while (!forward_queue.Empty() && !backward_queue.Empty()) {
+        if (forward_queue.PeekKey() + backward_queue.PeekKey() >= best){
+            break;
+        }
+
+        // Pick the direction to expand
+        bool is_forward = forward_queue.PeekKey() <= backward_queue.PeekKey();
+        QueueType &queue = is_forward ? forward_queue : backward_queue;
+        SearchContext &side = is_forward ? forward : backward;
+        SearchContext &other = is_forward ? backward : forward;
+        float sign = is_forward ? 1.0f : -1.0f;
+
+        int node;
+        float key;
+        queue.Pop(node, key);
+        stats.pops++;
+
+        // Skip zombie entries of nodes that were already expanded
+        if (side.IsVisited(node)) {
+            stats.stale_pops++;
+            continue;
+        }
+        side.SetVisited(node, true);
+        stats.expanded++;
+
+        // Relax the edges to the neighbors of the node
+        float node_cost = side.GetCost(node);
+        uint32_t edge_end = graph.EdgeEnd(node);
+        for (uint32_t e = graph.EdgeBegin(node); e < edge_end; e++){
+            int n = graph.GetTarget(e);
+            float n_cost = node_cost + graph.GetCost(e);
+
+            // Check if this edge connects the two searches with a
+            // cheaper path
+            if (other.IsReached(n)){
+                float total = n_cost + other.GetCost(n);
+                if (total < best){
+                    best = total;
+                    meet_forward = is_forward ? node : n;
+                    meet_backward = is_forward ? n : node;
+                }
+            }
+
+            // If the new cost is smaller than the current node cost,
+            // update the node and its entry in the queue
+            if (n_cost < side.GetCost(n)){
+                float nx = graph.GetX(n);
+                float ny = graph.GetY(n);
+                float potential = 0.5f*(heuristic.Estimate(nx, ny, end_x, end_y) - heuristic.Estimate(start_x, start_y, nx, ny));
+                side.SetCost(n, n_cost);
+                side.SetPrev(n, node);
+                queue.Push(n, n_cost + sign*potential);
+                stats.pushes++;
+            }
+        }
+    }
+
+    // Check if the searches met at all
+    if (meet_forward == -1){
+        return false;
+    }
+
+    // Join the forward path to the meeting edge with the backward path
+    // from there to the end
+    forward.GetPath(meet_forward, path);
+    if (meet_backward != meet_forward){
+        for (int current = meet_backward; current != -1; current = backward.GetPrev(current)){
+            path.push_back(current);
+        }
+    }
+    cost = best;
+    return true;
+}
+
+} // namespace game
+
+#endif // BIDIRECTIONAL_SEARCH_H_
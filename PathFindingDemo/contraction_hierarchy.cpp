@@ -0,0 +1,312 @@
+#include <cmath>
+#include <algorithm>
+
+#include "contraction_hierarchy.h"
+
+namespace game {
+
+// Maximum number of nodes settled by a witness search
+// Stopping early can only add unneeded shortcuts, never miss a needed
+// one, so this trades preprocessing time for a few more shortcuts
+const int max_witness_settled_g = 500;
+
+
+ContractionHierarchy::ContractionHierarchy(void){
+
+    Clear();
+}
+
+
+void ContractionHierarchy::Clear(void){
+
+    num_nodes_ = 0;
+    num_shortcuts_ = 0;
+    std::vector<int>().swap(rank_);
+    std::vector<uint32_t>(1, 0).swap(offset_);
+    std::vector<int>().swap(target_);
+    std::vector<float>().swap(cost_);
+    std::vector<int>().swap(middle_);
+}
+
+
+void ContractionHierarchy::AddEdge(std::vector<ContractionEdge> &edges, int target, float cost, int middle){
+
+    // Keep a single edge between two nodes, with the lowest cost
+    for (size_t i = 0; i < edges.size(); i++){
+        if (edges[i].target == target){
+            if (cost < edges[i].cost){
+                edges[i].cost = cost;
+                edges[i].middle = middle;
+            }
+            return;
+        }
+    }
+    ContractionEdge e = {target, cost, middle};
+    edges.push_back(e);
+}
+
+
+int ContractionHierarchy::Contract(int v, std::vector<std::vector<ContractionEdge> > &adj, bool simulate, SearchContext &witness){
+
+    // Copy the edges, since adding shortcuts can change adj[v] when
+    // two neighbors are already connected
+    std::vector<ContractionEdge> edges = adj[v];
+    int num_shortcuts = 0;
+    QuadHeap &queue = witness.GetHeap();
+
+    for (size_t i = 0; i < edges.size(); i++){
+        // Each pair of neighbors is handled once, from its first node
+        if (i + 1 >= edges.size()){
+            break;
+        }
+        int u = edges[i].target;
+
+        // Longest path through v that the witness search has to beat
+        float max_cost = 0.0f;
+        for (size_t j = i + 1; j < edges.size(); j++){
+            max_cost = std::max(max_cost, edges[i].cost + edges[j].cost);
+        }
+
+        // Search for paths from u that avoid v
+        witness.Reset(num_nodes_);
+        queue.Clear(num_nodes_);
+        witness.SetCost(u, 0.0f);
+        queue.Push(u, 0.0f);
+        int settled = 0;
+        while (!queue.Empty() && settled < max_witness_settled_g){
+            int node;
+            float cost;
+            queue.Pop(node, cost);
+            if (cost > max_cost){
+                break;
+            }
+            witness.SetVisited(node, true);
+            settled++;
+            for (size_t k = 0; k < adj[node].size(); k++){
+                const ContractionEdge &e = adj[node][k];
+                if (e.target == v){
+                    continue;
+                }
+                float c = cost + e.cost;
+                if (c < witness.GetCost(e.target)){
+                    witness.SetCost(e.target, c);
+                    queue.Push(e.target, c);
+                }
+            }
+        }
+
+        // Add a shortcut wherever the path through v is shorter than
+        // any witness
+        for (size_t j = i + 1; j < edges.size(); j++){
+            int w = edges[j].target;
+            float c = edges[i].cost + edges[j].cost;
+            if (witness.GetCost(w) > c){
+                num_shortcuts++;
+                if (!simulate){
+                    AddEdge(adj[u], w, c, v);
+                    AddEdge(adj[w], u, c, v);
+                }
+            }
+        }
+    }
+
+    return num_shortcuts;
+}
+
+
+void ContractionHierarchy::Build(const CsrGraph &graph){
+
+    Clear();
+    int n = graph.GetNumNodes();
+    if (n == 0){
+        return;
+    }
+    num_nodes_ = n;
+
+    // Copy the graph into adjacency lists that can change during the
+    // contraction, without loops or parallel edges
+    std::vector<std::vector<ContractionEdge> > adj(n);
+    for (int u = 0; u < n; u++){
+        for (uint32_t e = graph.EdgeBegin(u); e < graph.EdgeEnd(u); e++){
+            if (graph.GetTarget(e) != u){
+                AddEdge(adj[u], graph.GetTarget(e), graph.GetCost(e), -1);
+            }
+        }
+    }
+
+    // Order the nodes by edge difference (shortcuts added minus edges
+    // removed), plus the number of contracted neighbors so that the
+    // contraction spreads evenly over the graph
+    SearchContext witness;
+    std::vector<int> deleted(n, 0);
+    QuadHeap order;
+    order.Clear(n);
+    for (int v = 0; v < n; v++){
+        order.Push(v, Contract(v, adj, true, witness) - (int) adj[v].size());
+    }
+
+    // Contract the nodes, updating priorities lazily: a node is only
+    // contracted if its updated priority is still the lowest
+    std::vector<std::vector<ContractionEdge> > up(n);
+    rank_.assign(n, -1);
+    int next_rank = 0;
+    while (!order.Empty()){
+        int v;
+        float key;
+        order.Pop(v, key);
+        float priority = Contract(v, adj, true, witness) - (int) adj[v].size() + deleted[v];
+        if (!order.Empty() && priority > order.PeekKey()){
+            order.Push(v, priority);
+            continue;
+        }
+
+        Contract(v, adj, false, witness);
+        rank_[v] = next_rank++;
+
+        // The edges left on v all lead to nodes contracted later
+        up[v].swap(adj[v]);
+        for (size_t i = 0; i < up[v].size(); i++){
+            std::vector<ContractionEdge> &edges = adj[up[v][i].target];
+            for (size_t k = 0; k < edges.size(); k++){
+                if (edges[k].target == v){
+                    edges[k] = edges.back();
+                    edges.pop_back();
+                    break;
+                }
+            }
+            deleted[up[v][i].target]++;
+        }
+    }
+
+    // Store the upward graph in compressed sparse row format
+    offset_.reserve(n + 1);
+    for (int v = 0; v < n; v++){
+        for (size_t i = 0; i < up[v].size(); i++){
+            target_.push_back(up[v][i].target);
+            cost_.push_back(up[v][i].cost);
+            middle_.push_back(up[v][i].middle);
+            if (up[v][i].middle != -1){
+                num_shortcuts_++;
+            }
+        }
+        offset_.push_back(target_.size());
+    }
+}
+
+
+uint32_t ContractionHierarchy::FindEdge(int a, int b) const {
+
+    // The edge is stored with the endpoint that was contracted first
+    int low = rank_[a] < rank_[b] ? a : b;
+    int high = low == a ? b : a;
+    for (uint32_t e = offset_[low]; e < offset_[low+1]; e++){
+        if (target_[e] == high){
+            return e;
+        }
+    }
+    return offset_[low+1];
+}
+
+
+void ContractionHierarchy::UnpackEdge(int a, int b, std::vector<int> &path) const {
+
+    // Original edges are kept, shortcuts are replaced by the two edges
+    // through the bypassed node
+    int middle = middle_[FindEdge(a, b)];
+    if (middle == -1){
+        path.push_back(b);
+    } else {
+        UnpackEdge(a, middle, path);
+        UnpackEdge(middle, b, path);
+    }
+}
+
+
+bool ContractionHierarchy::FindPath(int start, int end, SearchContext &context, std::vector<int> &path, float &cost) const {
+
+    path.clear();
+    if (start == end){
+        path.push_back(start);
+        cost = 0.0f;
+        return true;
+    }
+
+    // Reset the state and the queues of both directions
+    SearchContext &forward = context;
+    SearchContext &backward = context.GetReverse();
+    forward.Reset(num_nodes_);
+    backward.Reset(num_nodes_);
+    QuadHeap &forward_queue = forward.GetHeap();
+    QuadHeap &backward_queue = backward.GetHeap();
+    forward_queue.Clear(num_nodes_);
+    backward_queue.Clear(num_nodes_);
+    SearchStats &stats = forward.GetStats();
+
+    forward.SetCost(start, 0.0f);
+    backward.SetCost(end, 0.0f);
+    forward_queue.Push(start, 0.0f);
+    backward_queue.Push(end, 0.0f);
+    stats.pushes += 2;
+
+    // Both searches only go upwards, and they meet at the highest node
+    // of the shortest path. Each one stops once its queue holds nothing
+    // cheaper than the best path found so far
+    float best = INFINITY;
+    int meet = -1;
+    while (true){
+        bool forward_active = !forward_queue.Empty() && forward_queue.PeekKey() < best;
+        bool backward_active = !backward_queue.Empty() && backward_queue.PeekKey() < best;
+        if (!forward_active && !backward_active){
+            break;
+        }
+        bool is_forward = forward_active && (!backward_active || forward_queue.PeekKey() <= backward_queue.PeekKey());
+        QuadHeap &queue = is_forward ? forward_queue : backward_queue;
+        SearchContext &side = is_forward ? forward : backward;
+        SearchContext &other = is_forward ? backward : forward;
+
+        int node;
+        float node_cost;
+        queue.Pop(node, node_cost);
+        stats.pops++;
+        side.SetVisited(node, true);
+        stats.expanded++;
+
+        // Check if the node connects both searches with a cheaper path
+        if (other.IsReached(node) && node_cost + other.GetCost(node) < best){
+            best = node_cost + other.GetCost(node);
+            meet = node;
+        }
+
+        // Relax the upward edges of the node
+        for (uint32_t e = offset_[node]; e < offset_[node+1]; e++){
+            int n = target_[e];
+            float c = node_cost + cost_[e];
+            if (c < side.GetCost(n)){
+                side.SetCost(n, c);
+                side.SetPrev(n, node);
+                queue.Push(n, c);
+                stats.pushes++;
+            }
+        }
+    }
+    if (meet == -1){
+        return false;
+    }
+
+    // Join the upward paths from both endpoints at the meeting node
+    std::vector<int> up_path;
+    forward.GetPath(meet, up_path);
+    for (int current = backward.GetPrev(meet); current != -1; current = backward.GetPrev(current)){
+        up_path.push_back(current);
+    }
+
+    // Replace the shortcuts by the original edges
+    path.push_back(up_path[0]);
+    for (size_t i = 1; i < up_path.size(); i++){
+        UnpackEdge(up_path[i-1], up_path[i], path);
+    }
+    cost = best;
+    return true;
+}
+
+} // namespace game
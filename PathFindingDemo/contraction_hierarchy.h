@@ -0,0 +1,107 @@
+#ifndef CONTRACTION_HIERARCHY_H_
+#define CONTRACTION_HIERARCHY_H_
+
+#include <vector>
+#include <cstdint>
+
+#include "csr_graph.h"
+#include "search_context.h"
+
+namespace game {
+
+// Contraction Hierarchies (CH) for fast queries on a static graph
+//
+// Preprocessing removes ("contracts") the nodes one at a time, from the
+// least to the most important. When a node is removed, shortcut edges
+// are added between its remaining neighbors wherever the path through
+// the node is the only shortest one, so distances between the remaining
+// nodes are preserved. Each node keeps its edges to the nodes that were
+// contracted after it: the upward graph
+//
+// A query then runs a bidirectional Dijkstra search that only follows
+// upward edges from both endpoints, which settles a tiny fraction of the
+// graph. Shortcuts on the resulting path are unpacked recursively into
+// the original edges. Edges are assumed to be symmetric, as created by
+// Node::AddNeighbor, so the same upward graph serves both directions
+//
+// The upward graph is exposed with the same interface as a CsrGraph
+class ContractionHierarchy {
+
+    public:
+        // Create an empty hierarchy that is not ready to be used
+        ContractionHierarchy(void);
+
+        // Contract all the nodes of the graph and build the upward graph
+        void Build(const CsrGraph &graph);
+
+        // Release all memory and make the hierarchy not ready
+        void Clear(void);
+
+        // Check if the hierarchy was built
+        inline bool IsReady(void) const { return num_nodes_ > 0; }
+
+        // Get the number of shortcuts added by the preprocessing
+        inline int GetNumShortcuts(void) const { return num_shortcuts_; }
+
+        // Get the position of node n in the contraction order
+        inline int GetRank(int n) const { return rank_[n]; }
+
+        // Upward graph: edges from each node to higher-ranked nodes
+        inline int GetNumNodes(void) const { return num_nodes_; }
+        inline uint32_t EdgeBegin(int n) const { return offset_[n]; }
+        inline uint32_t EdgeEnd(int n) const { return offset_[n+1]; }
+        inline int GetTarget(uint32_t e) const { return target_[e]; }
+        inline float GetCost(uint32_t e) const { return cost_[e]; }
+
+        // Find a shortest path between nodes start and end, using the
+        // given context (and its reverse context) for the search state
+        // The path lists the original nodes from start to end. Returns
+        // false if there is no path
+        bool FindPath(int start, int end, SearchContext &context, std::vector<int> &path, float &cost) const;
+
+        // Append the original nodes of the upward edge between nodes a and
+        // b to path, from a to b and excluding a
+        void UnpackEdge(int a, int b, std::vector<int> &path) const;
+
+    private:
+        // Edge of the graph during the contraction
+        struct ContractionEdge {
+            int target; // Index of the neighbor
+            float cost; // Cost of the edge
+            int middle; // Node bypassed by a shortcut, or -1
+        };
+
+        // Number of nodes in the hierarchy
+        int num_nodes_;
+
+        // Number of shortcuts in the upward graph
+        int num_shortcuts_;
+
+        // Position of each node in the contraction order
+        std::vector<int> rank_;
+
+        // Upward graph in compressed sparse row format, with the node
+        // bypassed by each shortcut, or -1 for original edges
+        std::vector<uint32_t> offset_;
+        std::vector<int> target_;
+        std::vector<float> cost_;
+        std::vector<int> middle_;
+
+        // Remove node v from the remaining graph adj, adding the required
+        // shortcuts between its neighbors, and return the number of
+        // shortcuts
+        // If simulate is set, the graph is not changed and only the
+        // number of shortcuts is computed
+        int Contract(int v, std::vector<std::vector<ContractionEdge> > &adj, bool simulate, SearchContext &witness);
+
+        // Add an edge to the remaining graph, or lower the cost of the
+        // existing edge between the two nodes
+        static void AddEdge(std::vector<ContractionEdge> &edges, int target, float cost, int middle);
+
+        // Find the upward edge between nodes a and b
+        uint32_t FindEdge(int a, int b) const;
+};
+
+} // namespace game
+
+#endif // CONTRACTION_HIERARCHY_H_
@@ -0,0 +1,113 @@
+#include <stdexcept>
+#include <string>
+#include <cmath>
+#include <algorithm>
+
+#include "csr_graph.h"
+
+namespace game {
+
+CsrGraph::CsrGraph(void){
+
+    // Start with an empty graph
+    Clear();
+}
+
+
+void CsrGraph::Build(const std::vector<Node*> &node){
+
+    int num_nodes = node.size();
+    int old_nodes = std::min(num_nodes_, num_nodes);
+
+    // Count the edges of each node first, the ones already in the graph
+    // plus the ones stored in the node, so that each array is allocated
+    // only once
+    std::vector<uint32_t> offset(num_nodes + 1, 0);
+    for (int i = 0; i < num_nodes; i++){
+        if (node[i]->GetId() != i){
+            throw(std::runtime_error(std::string("Node id does not match its index: ") + std::to_string(node[i]->GetId())));
+        }
+        uint32_t count = node[i]->GetNumEdges();
+        if (i < old_nodes){
+            count += EdgeEnd(i) - EdgeBegin(i);
+        }
+        offset[i+1] = offset[i] + count;
+    }
+    std::vector<uint32_t> target(offset[num_nodes]);
+    std::vector<float> cost(offset[num_nodes]);
+    std::vector<float> x(num_nodes), y(num_nodes);
+
+    // Copy the edges of each node into the contiguous arrays, after the
+    // edges it already had
+    min_cost_ = INFINITY;
+    max_cost_ = 0.0;
+    integer_costs_ = true;
+    for (int i = 0; i < num_nodes; i++){
+        x[i] = node[i]->GetX();
+        y[i] = node[i]->GetY();
+        uint32_t e = offset[i];
+        if (i < old_nodes){
+            for (uint32_t old = EdgeBegin(i); old < EdgeEnd(i); old++, e++){
+                target[e] = target_[old];
+                cost[e] = cost_[old];
+                TrackCost(cost[e]);
+            }
+        }
+        for (int j = 0; j < node[i]->GetNumEdges(); j++, e++){
+            const Edge &edge = node[i]->GetEdge(j);
+            target[e] = edge.n2->GetId();
+            cost[e] = edge.cost;
+            TrackCost(cost[e]);
+        }
+    }
+
+    num_nodes_ = num_nodes;
+    offset_.swap(offset);
+    target_.swap(target);
+    cost_.swap(cost);
+    x_.swap(x);
+    y_.swap(y);
+}
+
+
+void CsrGraph::Clear(void){
+
+    // Swap with empty vectors to actually release the memory
+    num_nodes_ = 0;
+    std::vector<uint32_t>(1, 0).swap(offset_);
+    std::vector<uint32_t>().swap(target_);
+    std::vector<float>().swap(cost_);
+    std::vector<float>().swap(x_);
+    std::vector<float>().swap(y_);
+
+    // An empty graph has the full range of costs until edges are added
+    min_cost_ = INFINITY;
+    max_cost_ = 0.0;
+    integer_costs_ = true;
+}
+
+
+void CsrGraph::SetCost(uint32_t e, float cost){
+
+    cost_[e] = cost;
+    TrackCost(cost);
+}
+
+
+void CsrGraph::TrackCost(float cost){
+
+    // Keep track of the kind of costs in the graph
+    min_cost_ = std::min(min_cost_, cost);
+    max_cost_ = std::max(max_cost_, cost);
+    if (cost != std::floor(cost)){
+        integer_costs_ = false;
+    }
+}
+
+
+bool CsrGraph::HasIntegerCosts(int max_cost) const {
+
+    return integer_costs_ && min_cost_ >= 0.0 && max_cost_ <= max_cost;
+}
+
+} // namespace game
@@ -0,0 +1,92 @@
+#ifndef CSR_GRAPH_H_
+#define CSR_GRAPH_H_
+
+#include <vector>
+#include <cstdint>
+
+#include "node.h"
+
+namespace game {
+
+// A graph in compressed sparse row (CSR) format
+//
+// The outgoing edges of node n are stored contiguously in the range
+// [EdgeBegin(n), EdgeEnd(n)) of the target and cost arrays, so a
+// search can relax all the neighbors of a node by scanning a single
+// block of memory instead of following pointers across the heap
+//
+// Once built, this is the only copy of the edges: the edges added to
+// the nodes are moved here by Build(), and the nodes can release them
+class CsrGraph {
+
+    public:
+        // Create an empty graph
+        CsrGraph(void);
+
+        // Add the edges stored in a list of nodes to the edges already
+        // in the graph, and take the positions of the nodes
+        // Assumes the id of a node corresponds to its index in the list,
+        // and that the list only grew since the last call
+        void Build(const std::vector<Node*> &node);
+
+        // Release the memory used by the graph
+        void Clear(void);
+
+        // Get size information
+        inline int GetNumNodes(void) const { return num_nodes_; }
+        inline int GetNumEdges(void) const { return target_.size(); }
+
+        // Get the position of node n
+        inline float GetX(int n) const { return x_[n]; }
+        inline float GetY(int n) const { return y_[n]; }
+
+        // Get the range of edges leaving node n
+        inline uint32_t EdgeBegin(int n) const { return offset_[n]; }
+        inline uint32_t EdgeEnd(int n) const { return offset_[n+1]; }
+
+        // Get the target node index and the cost of edge e
+        inline int GetTarget(uint32_t e) const { return target_[e]; }
+        inline float GetCost(uint32_t e) const { return cost_[e]; }
+
+        // Change the cost of edge e in place
+        // The range of costs only grows, so it stays a valid bound
+        void SetCost(uint32_t e, float cost);
+
+        // Get the range of the edge costs
+        inline float GetMinCost(void) const { return min_cost_; }
+        inline float GetMaxCost(void) const { return max_cost_; }
+
+        // Check if every edge cost is a non-negative integer no larger
+        // than max_cost, so that integer priority queues can be used
+        bool HasIntegerCosts(int max_cost) const;
+
+    private:
+        // Number of nodes in the graph
+        int num_nodes_;
+
+        // Index of the first edge of each node, plus one entry past the
+        // end of the last node
+        std::vector<uint32_t> offset_;
+
+        // Target node index of each edge
+        std::vector<uint32_t> target_;
+
+        // Cost of traversing each edge
+        std::vector<float> cost_;
+
+        // Position of each node, used by search heuristics
+        std::vector<float> x_, y_;
+
+        // Range of the edge costs
+        float min_cost_, max_cost_;
+
+        // Flag indicating that all edge costs are integers
+        bool integer_costs_;
+
+        // Widen the range of costs to include the given cost
+        void TrackCost(float cost);
+};
+
+} // namespace game
+
+#endif // CSR_GRAPH_H_
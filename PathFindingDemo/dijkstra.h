@@ -0,0 +1,74 @@
+#ifndef DIJKSTRA_H_
+#define DIJKSTRA_H_
+
+#include <cstdint>
+
+#include "search_context.h"
+
+namespace game {
+
+// Dijkstra's algorithm from start until the end node is expanded
+//
+// The graph type needs to provide the compact-graph interface
+// (GetNumNodes, EdgeBegin, EdgeEnd, GetTarget, GetCost), and the queue
+// type is one of the policies in search_queue.h. All state is written
+// to the context, including the search statistics, and the path can be
+// read back with SearchContext::GetPath. Returns false if the end node
+// cannot be reached
+template <typename GraphType, typename QueueType>
+bool Dijkstra(const GraphType &graph, int start, int end, QueueType &queue, SearchContext &context){
+
+    // Reset the search state and the queue
+    context.Reset(graph.GetNumNodes());
+    queue.Clear(graph.GetNumNodes());
+    SearchStats &stats = context.GetStats();
+
+    // The start node is added to the queue with cost 0
+    context.SetCost(start, 0.0);
+    queue.Push(start, 0.0);
+    stats.pushes++;
+
+    while (!queue.Empty()) {
+        // Remove the current lowest-cost node from the queue
+        int node;
+        float cost;
+        queue.Pop(node, cost);
+        stats.pops++;
+
+        // Skip zombie entries of nodes that were already expanded with
+        // a lower cost
+        if (context.IsVisited(node)) {
+            stats.stale_pops++;
+            continue;
+        }
+        context.SetVisited(node, true);
+        stats.expanded++;
+
+        // If the current node is the end node, we are done
+        if (node == end) {
+            return true;
+        }
+
+        // Otherwise, relax the edges to the neighbors of the node
+        uint32_t edge_end = graph.EdgeEnd(node);
+        for (uint32_t e = graph.EdgeBegin(node); e < edge_end; e++){
+            int n = graph.GetTarget(e);
+            float node_cost = cost + graph.GetCost(e);
+
+            // If the new cost is smaller than the current node cost,
+            // update the node and its entry in the queue
+            if (node_cost < context.GetCost(n)){
+                context.SetCost(n, node_cost);
+                context.SetPrev(n, node);
+                queue.Push(n, node_cost);
+                stats.pushes++;
+            }
+        }
+    }
+
+    return false;
+}
+
+} // namespace game
+
+#endif // DIJKSTRA_H_
@@ -0,0 +1,142 @@
+#include <algorithm>
+
+#include "distance_table.h"
+
+namespace game {
+
+DistanceTable::DistanceTable(int num_threads) : pool_(num_threads) {
+
+    // One search context per worker
+    for (int i = 0; i < pool_.GetNumThreads(); i++){
+        worker_.push_back(std::unique_ptr<Worker>(new Worker()));
+    }
+}
+
+
+void DistanceTable::Compute(const ContractionHierarchy &ch, const int *sources, int num_sources, const int *targets, int num_targets, std::vector<int> *paths, float *costs){
+
+    int num_nodes = ch.GetNumNodes();
+
+    // Run the upward search of each target in parallel
+    // The edges are symmetric, so the upward graph also gives the costs
+    // from the settled nodes to the target
+    if (up_.size() < (size_t) num_targets){
+        up_.resize(num_targets);
+    }
+    pool_.Run(num_targets, [&](int j, int thread){
+        SearchUp(ch, targets[j], j, worker_[thread]->context, up_[j]);
+    });
+
+    // Gather the results into buckets sorted by node
+    bucket_.clear();
+    for (int j = 0; j < num_targets; j++){
+        bucket_.insert(bucket_.end(), up_[j].begin(), up_[j].end());
+    }
+    std::sort(bucket_.begin(), bucket_.end(), [](const BucketEntry &a, const BucketEntry &b) { return a.node < b.node; });
+    if (first_.size() != (size_t) num_nodes){
+        first_.assign(num_nodes, -1);
+    }
+    for (int k = bucket_.size() - 1; k >= 0; k--){
+        first_[bucket_[k].node] = k;
+    }
+
+    // Run the upward search of each source in parallel, and combine it
+    // with the buckets of the nodes it settles. Each source only writes
+    // its own row
+    pool_.Run(num_sources, [&](int i, int thread){
+        Worker &worker = *worker_[thread];
+        float *row = costs + (size_t) i*num_targets;
+        std::fill(row, row + num_targets, INFINITY);
+        std::vector<BucketEntry> &settled = worker.settled;
+        SearchUp(ch, sources[i], -1, worker.context, settled);
+        for (size_t s = 0; s < settled.size(); s++){
+            int k = first_[settled[s].node];
+            if (k == -1){
+                continue;
+            }
+            for (; k < (int) bucket_.size() && bucket_[k].node == settled[s].node; k++){
+                float cost = settled[s].cost + bucket_[k].cost;
+                if (cost < row[bucket_[k].target]){
+                    row[bucket_[k].target] = cost;
+                }
+            }
+        }
+    });
+
+    // Only reset the nodes that have a bucket
+    for (size_t k = 0; k < bucket_.size(); k++){
+        first_[bucket_[k].node] = -1;
+    }
+
+    // Paths are unpacked by a query per pair that has one, with a task
+    // per source so that the number of tasks does not overflow
+    if (paths != NULL){
+        pool_.Run(num_sources, [&](int i, int thread){
+            for (int j = 0; j < num_targets; j++){
+                size_t k = (size_t) i*num_targets + j;
+                paths[k].clear();
+                if (costs[k] != INFINITY){
+                    float cost;
+                    ch.FindPath(sources[i], targets[j], worker_[thread]->context, paths[k], cost);
+                }
+            }
+        });
+    }
+}
+
+
+void DistanceTable::SearchUp(const ContractionHierarchy &ch, int start, int target, SearchContext &context, std::vector<BucketEntry> &settled){
+
+    int num_nodes = ch.GetNumNodes();
+    QuadHeap &queue = context.GetHeap();
+    context.Reset(num_nodes);
+    queue.Clear(num_nodes);
+    context.SetCost(start, 0.0f);
+    queue.Push(start, 0.0f);
+
+    // Without an end node, the search runs until the upward graph of the
+    // start node is exhausted, which is small on a hierarchy
+    settled.clear();
+    while (!queue.Empty()){
+        int node;
+        float cost;
+        queue.Pop(node, cost);
+        BucketEntry entry = {node, target, cost};
+        settled.push_back(entry);
+        uint32_t edge_end = ch.EdgeEnd(node);
+        for (uint32_t e = ch.EdgeBegin(node); e < edge_end; e++){
+            int n = ch.GetTarget(e);
+            float node_cost = cost + ch.GetCost(e);
+            if (node_cost < context.GetCost(n)){
+                context.SetCost(n, node_cost);
+                queue.Push(n, node_cost);
+            }
+        }
+    }
+}
+
+
+int DistanceTable::MarkTargets(int num_nodes, const int *targets, int num_targets){
+
+    if (is_target_.size() != (size_t) num_nodes){
+        is_target_.assign(num_nodes, 0);
+    }
+    int num_distinct = 0;
+    for (int j = 0; j < num_targets; j++){
+        if (!is_target_[targets[j]]){
+            is_target_[targets[j]] = 1;
+            num_distinct++;
+        }
+    }
+    return num_distinct;
+}
+
+
+void DistanceTable::UnmarkTargets(const int *targets, int num_targets){
+
+    for (int j = 0; j < num_targets; j++){
+        is_target_[targets[j]] = 0;
+    }
+}
+
+} // namespace game
@@ -0,0 +1,147 @@
+#ifndef DISTANCE_TABLE_H_
+#define DISTANCE_TABLE_H_
+
+#include <vector>
+#include <memory>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+
+#include "search_context.h"
+#include "contraction_hierarchy.h"
+#include "thread_pool.h"
+
+namespace game {
+
+// Computes the costs between every node of a set of sources and every
+// node of a set of targets, on a pool of worker threads
+//
+// On a Contraction Hierarchy, this is the bucket-based many-to-many
+// algorithm: an upward search from each target leaves its cost in a
+// bucket at every node it settles, then an upward search from each
+// source reads the buckets of the nodes it settles. This costs one small
+// search per source and per target instead of one per pair. On other
+// graphs, one Dijkstra search per source runs until all the targets are
+// settled. The searches from the sources run in parallel, and paths are
+// only built when asked for
+class DistanceTable {
+
+    public:
+        // Start the given number of workers, or one per hardware thread
+        // if num_threads is 0
+        DistanceTable(int num_threads = 0);
+
+        // Get the number of worker threads
+        inline int GetNumThreads(void) const { return pool_.GetNumThreads(); }
+
+        // Compute the costs from sources to targets on a hierarchy
+        //
+        // The cost from sources[i] to targets[j] is stored in
+        // costs[i*num_targets + j], or INFINITY if there is no path. If
+        // paths is not NULL, the entry with the same index receives the
+        // node indices on the path, and is empty if there is no path
+        void Compute(const ContractionHierarchy &ch, const int *sources, int num_sources, const int *targets, int num_targets, std::vector<int> *paths, float *costs);
+
+        // Compute the costs from sources to targets, with the same
+        // results as above, on a graph type that provides the
+        // compact-graph interface, such as CsrGraph or GridGraph
+        template <typename GraphType>
+        void Compute(const GraphType &graph, const int *sources, int num_sources, const int *targets, int num_targets, std::vector<int> *paths, float *costs){
+
+            // Flag the targets so that a search knows when it is done
+            int num_nodes = graph.GetNumNodes();
+            int num_distinct = MarkTargets(num_nodes, targets, num_targets);
+
+            pool_.Run(num_sources, [&](int i, int thread){
+                SearchContext &context = worker_[thread]->context;
+                QuadHeap &queue = context.GetHeap();
+                context.Reset(num_nodes);
+                queue.Clear(num_nodes);
+                context.SetCost(sources[i], 0.0f);
+                queue.Push(sources[i], 0.0f);
+
+                // Dijkstra's algorithm until every target is settled
+                int remaining = num_distinct;
+                while (!queue.Empty() && remaining > 0){
+                    int node;
+                    float cost;
+                    queue.Pop(node, cost);
+                    context.SetVisited(node, true);
+                    if (is_target_[node]){
+                        remaining--;
+                    }
+                    uint32_t edge_end = graph.EdgeEnd(node);
+                    for (uint32_t e = graph.EdgeBegin(node); e < edge_end; e++){
+                        int n = graph.GetTarget(e);
+                        float node_cost = cost + graph.GetCost(e);
+                        if (node_cost < context.GetCost(n)){
+                            context.SetCost(n, node_cost);
+                            context.SetPrev(n, node);
+                            queue.Push(n, node_cost);
+                        }
+                    }
+                }
+
+                // Read the row of the source from the search
+                for (int j = 0; j < num_targets; j++){
+                    size_t k = (size_t) i*num_targets + j;
+                    bool found = context.IsVisited(targets[j]);
+                    costs[k] = found ? context.GetCost(targets[j]) : INFINITY;
+                    if (paths != NULL){
+                        paths[k].clear();
+                        if (found){
+                            context.GetPath(targets[j], paths[k]);
+                        }
+                    }
+                }
+            });
+            UnmarkTargets(targets, num_targets);
+        }
+
+    private:
+        // Cost from a node up to a target, left by the search from the
+        // target
+        struct BucketEntry {
+            int node; // Node settled by the search
+            int target; // Position of the target in the list of targets
+            float cost; // Cost between the node and the target
+        };
+
+        // Worker threads
+        ThreadPool pool_;
+
+        // State of a worker
+        struct Worker {
+            SearchContext context; // Search state
+            std::vector<BucketEntry> settled; // Nodes settled from a source
+        };
+
+        // State of each worker, allocated separately so that the workers
+        // do not write to the same cache lines
+        std::vector<std::unique_ptr<Worker> > worker_;
+
+        // Nodes settled by the upward search from each target
+        std::vector<std::vector<BucketEntry> > up_;
+
+        // Bucket entries sorted by node, and the position of the first
+        // entry of each node, or -1
+        std::vector<BucketEntry> bucket_;
+        std::vector<int> first_;
+
+        // Flag for each node indicating whether it is a target
+        std::vector<unsigned char> is_target_;
+
+        // Flag the targets and return the number of distinct ones
+        int MarkTargets(int num_nodes, const int *targets, int num_targets);
+
+        // Reset the flags of the targets
+        void UnmarkTargets(const int *targets, int num_targets);
+
+        // Run an upward search from node start on the hierarchy and store
+        // the nodes it settles with their costs
+        static void SearchUp(const ContractionHierarchy &ch, int start, int target, SearchContext &context, std::vector<BucketEntry> &settled);
+};
+
+} // namespace game
+
+#endif // DISTANCE_TABLE_H_
@@ -0,0 +1,198 @@
+#include <cmath>
+#include <algorithm>
+
+#include "dstar_lite.h"
+
+namespace game {
+
+DStarLite::DStarLite(void){
+
+    Clear();
+}
+
+
+void DStarLite::Clear(void){
+
+    graph_ = NULL;
+    start_ = -1;
+    goal_ = -1;
+    last_start_ = -1;
+    km_ = 0.0f;
+    std::vector<float>().swap(g_);
+    std::vector<float>().swap(rhs_);
+    queue_ = IndexedHeap<4, Key>();
+    stats_ = SearchStats();
+}
+
+
+void DStarLite::Start(const CsrGraph &graph, int start, int goal, const Heuristic &heuristic){
+
+    graph_ = &graph;
+    start_ = start;
+    goal_ = goal;
+    last_start_ = start;
+    heuristic_ = heuristic;
+    km_ = 0.0f;
+    stats_ = SearchStats();
+
+    // All nodes are unreached, except that the goal has cost 0
+    int n = graph.GetNumNodes();
+    g_.assign(n, INFINITY);
+    rhs_.assign(n, INFINITY);
+    queue_.Clear(n);
+    rhs_[goal] = 0.0f;
+    queue_.Push(goal, CalculateKey(goal));
+}
+
+
+float DStarLite::Estimate(int n) const {
+
+    return heuristic_.Estimate(graph_->GetX(start_), graph_->GetY(start_), graph_->GetX(n), graph_->GetY(n));
+}
+
+
+DStarLite::Key DStarLite::CalculateKey(int n) const {
+
+    float cost = std::min(g_[n], rhs_[n]);
+    Key key = {cost + Estimate(n) + km_, cost};
+    return key;
+}
+
+
+void DStarLite::MoveStart(int start){
+
+    // The keys in the queue were computed from the previous start
+    // Instead of updating them, later keys are raised by the estimate
+    // of the move, which keeps the order of the queue
+    start_ = start;
+    km_ += heuristic_.Estimate(graph_->GetX(last_start_), graph_->GetY(last_start_), graph_->GetX(start), graph_->GetY(start));
+    last_start_ = start;
+}
+
+
+void DStarLite::UpdateEdge(int u, int v){
+
+    // The edges are symmetric, so both endpoints may have a new rhs
+    UpdateRhs(u);
+    UpdateVertex(u);
+    UpdateRhs(v);
+    UpdateVertex(v);
+}
+
+
+void DStarLite::UpdateRhs(int n){
+
+    if (n == goal_){
+        return;
+    }
+    float rhs = INFINITY;
+    uint32_t edge_end = graph_->EdgeEnd(n);
+    for (uint32_t e = graph_->EdgeBegin(n); e < edge_end; e++){
+        rhs = std::min(rhs, graph_->GetCost(e) + g_[graph_->GetTarget(e)]);
+    }
+    rhs_[n] = rhs;
+}
+
+
+void DStarLite::UpdateVertex(int n){
+
+    if (g_[n] != rhs_[n]){
+        if (!queue_.Contains(n)){
+            queue_.Push(n, CalculateKey(n));
+            stats_.pushes++;
+        } else {
+            queue_.Update(n, CalculateKey(n));
+        }
+    } else if (queue_.Contains(n)){
+        queue_.Remove(n);
+    }
+}
+
+
+void DStarLite::ComputeShortestPath(void){
+
+    while (!queue_.Empty() && (queue_.PeekKey() < CalculateKey(start_) || rhs_[start_] != g_[start_])){
+        int u = queue_.PeekNode();
+        Key old_key = queue_.PeekKey();
+        Key new_key = CalculateKey(u);
+        stats_.pops++;
+
+        // The key is outdated by moves of the start node
+        if (old_key < new_key){
+            queue_.Update(u, new_key);
+            stats_.stale_pops++;
+            continue;
+        }
+        stats_.expanded++;
+
+        uint32_t edge_end = graph_->EdgeEnd(u);
+        if (g_[u] > rhs_[u]){
+            // The cost of u dropped: settle it and lower the rhs of its
+            // neighbors
+            g_[u] = rhs_[u];
+            queue_.Remove(u);
+            for (uint32_t e = graph_->EdgeBegin(u); e < edge_end; e++){
+                int s = graph_->GetTarget(e);
+                if (s != goal_){
+                    rhs_[s] = std::min(rhs_[s], graph_->GetCost(e) + g_[u]);
+                }
+                UpdateVertex(s);
+            }
+        } else {
+            // The cost of u rose: reset it, and recompute the rhs of the
+            // neighbors that went through it
+            float g_old = g_[u];
+            g_[u] = INFINITY;
+            for (uint32_t e = graph_->EdgeBegin(u); e < edge_end; e++){
+                int s = graph_->GetTarget(e);
+                if (rhs_[s] == graph_->GetCost(e) + g_old){
+                    UpdateRhs(s);
+                }
+                UpdateVertex(s);
+            }
+            UpdateRhs(u);
+            UpdateVertex(u);
+        }
+    }
+}
+
+
+bool DStarLite::FindPath(std::vector<int> &path, float &cost){
+
+    path.clear();
+    ComputeShortestPath();
+    if (g_[start_] == INFINITY){
+        return false;
+    }
+
+    // Follow the cheapest neighbor from the start to the goal
+    // The length is bounded in case rounding creates a loop
+    int n = start_;
+    path.push_back(n);
+    while (n != goal_ && path.size() <= g_.size()){
+        int best = -1;
+        float best_cost = INFINITY;
+        uint32_t edge_end = graph_->EdgeEnd(n);
+        for (uint32_t e = graph_->EdgeBegin(n); e < edge_end; e++){
+            float c = graph_->GetCost(e) + g_[graph_->GetTarget(e)];
+            if (c < best_cost){
+                best_cost = c;
+                best = graph_->GetTarget(e);
+            }
+        }
+        if (best == -1){
+            path.clear();
+            return false;
+        }
+        n = best;
+        path.push_back(n);
+    }
+    if (n != goal_){
+        path.clear();
+        return false;
+    }
+    cost = g_[start_];
+    return true;
+}
+
+} // namespace game
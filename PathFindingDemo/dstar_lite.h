@@ -0,0 +1,109 @@
+#ifndef DSTAR_LITE_H_
+#define DSTAR_LITE_H_
+
+#include <vector>
+
+#include "csr_graph.h"
+#include "search_context.h"
+#include "search_queue.h"
+#include "heuristic.h"
+
+namespace game {
+
+// D* Lite: shortest paths that are repaired instead of recomputed when
+// edge costs change or the start node moves
+//
+// The search runs backwards from the goal, and keeps for each node its
+// cost to the goal (g) and a one-step lookahead of that cost (rhs).
+// After a change, only the nodes whose costs are affected are queued
+// again, so most of the previous search is reused. Moving the start
+// node only shifts the keys of the queue by the estimate of the move
+// (km), without touching the queued nodes
+//
+// Edges are assumed to be symmetric, as created by Node::AddNeighbor.
+// The heuristic has to stay admissible for the new edge costs, so a new
+// search has to be started if costs drop below its scale
+class DStarLite {
+
+    public:
+        // Create an engine that is not started
+        DStarLite(void);
+
+        // Start a new search on the graph towards the goal node
+        // The graph is kept by reference and is read again after each
+        // change, so it must stay alive while the engine is used
+        void Start(const CsrGraph &graph, int start, int goal, const Heuristic &heuristic);
+
+        // Release all memory and stop the search
+        void Clear(void);
+
+        // Getters
+        inline bool IsStarted(void) const { return graph_ != NULL; }
+        inline int GetStart(void) const { return start_; }
+        inline int GetGoal(void) const { return goal_; }
+        inline const Heuristic &GetHeuristic(void) const { return heuristic_; }
+        inline const SearchStats &GetStats(void) const { return stats_; }
+
+        // Move the start node to another node
+        void MoveStart(int start);
+
+        // Take into account that the costs of the edges between nodes u
+        // and v changed in the graph
+        void UpdateEdge(int u, int v);
+
+        // Repair the search and store the nodes on the shortest path from
+        // the start to the goal in path, and its cost in cost
+        // Returns false if there is no path
+        bool FindPath(std::vector<int> &path, float &cost);
+
+    private:
+        // Priority of a queued node, compared lexicographically
+        struct Key {
+            float k1; // Estimated cost of a path through the node
+            float k2; // Cost from the node to the goal
+
+            inline bool operator<(const Key &b) const { return k1 < b.k1 || (k1 == b.k1 && k2 < b.k2); }
+        };
+
+        // Graph being searched
+        const CsrGraph *graph_;
+
+        // Current start and goal nodes
+        int start_, goal_;
+
+        // Start node when the keys were last computed
+        int last_start_;
+
+        // Distance estimate, and the sum of the estimates of all moves of
+        // the start node
+        Heuristic heuristic_;
+        float km_;
+
+        // Cost to the goal and its one-step lookahead for each node
+        std::vector<float> g_, rhs_;
+
+        // Nodes whose g and rhs differ
+        IndexedHeap<4, Key> queue_;
+
+        // Statistics of the searches since the engine was started
+        SearchStats stats_;
+
+        // Compute the key of node n
+        Key CalculateKey(int n) const;
+
+        // Estimate the cost between the start and node n
+        float Estimate(int n) const;
+
+        // Recompute rhs of node n from its neighbors
+        void UpdateRhs(int n);
+
+        // Queue node n if g and rhs differ, and remove it otherwise
+        void UpdateVertex(int n);
+
+        // Expand nodes until the start node is consistent
+        void ComputeShortestPath(void);
+};
+
+} // namespace game
+
+#endif // DSTAR_LITE_H_
@@ -0,0 +1,112 @@
+#ifndef FLOW_FIELD_H_
+#define FLOW_FIELD_H_
+
+#include <vector>
+#include <cmath>
+#include <cstdint>
+
+#include "search_context.h"
+#include "search_queue.h"
+
+namespace game {
+
+// Next step towards one goal node from every node of a graph
+//
+// A single Dijkstra search runs backwards from the goal until all
+// reachable nodes are settled, and each node keeps the neighbor it was
+// reached from. Any number of units heading to the goal then move by
+// reading the next hop of the node they are on, so a crowd costs one
+// search per goal instead of one per unit. The graph type needs to
+// provide the compact-graph interface, such as CsrGraph or GridGraph,
+// and its edges have to be symmetric, as created by Node::AddNeighbor.
+// The field has to be built again after the graph changes
+template <typename GraphType>
+class FlowField {
+
+    public:
+        // Create a field that does not lead anywhere
+        FlowField(void) { goal_ = -1; }
+
+        // Compute the next hop of every node towards the goal node
+        void Build(const GraphType &graph, int goal){
+            int num_nodes = graph.GetNumNodes();
+            goal_ = goal;
+            next_.assign(num_nodes, -1);
+            cost_.assign(num_nodes, INFINITY);
+            stats_ = SearchStats();
+
+            // The edges are symmetric, so relaxing the edges out of a
+            // node also relaxes the edges into it
+            heap_.Clear(num_nodes);
+            cost_[goal] = 0.0f;
+            heap_.Push(goal, 0.0f);
+            stats_.pushes++;
+            while (!heap_.Empty()){
+                int node;
+                float cost;
+                heap_.Pop(node, cost);
+                stats_.pops++;
+                stats_.expanded++;
+                uint32_t edge_end = graph.EdgeEnd(node);
+                for (uint32_t e = graph.EdgeBegin(node); e < edge_end; e++){
+                    int n = graph.GetTarget(e);
+                    float node_cost = cost + graph.GetCost(e);
+                    if (node_cost < cost_[n]){
+                        cost_[n] = node_cost;
+                        next_[n] = node;
+                        heap_.Push(n, node_cost);
+                        stats_.pushes++;
+                    }
+                }
+            }
+        }
+
+        // Drop the field and release its memory
+        inline void Clear(void) { goal_ = -1; std::vector<int>().swap(next_); std::vector<float>().swap(cost_); }
+
+        // Getters
+        inline bool IsReady(void) const { return goal_ != -1; }
+        inline int GetGoal(void) const { return goal_; }
+        inline const SearchStats &GetStats(void) const { return stats_; }
+
+        // Get the node to move to from node n, or -1 if n is the goal or
+        // cannot reach it
+        inline int GetNextHop(int n) const { return next_[n]; }
+
+        // Check if the goal can be reached from node n
+        inline bool Reaches(int n) const { return cost_[n] != INFINITY; }
+
+        // Get the cost of the shortest path from node n to the goal
+        inline float GetCost(int n) const { return cost_[n]; }
+
+        // Store the nodes on the path from node n to the goal, in order
+        // Returns false if the goal cannot be reached
+        bool GetPath(int n, std::vector<int> &path) const {
+            path.clear();
+            if (!Reaches(n)){
+                return false;
+            }
+            for (; n != -1; n = next_[n]){
+                path.push_back(n);
+            }
+            return true;
+        }
+
+    private:
+        // Node all hops lead to, or -1 if the field is not built
+        int goal_;
+
+        // Next hop and cost to the goal of each node
+        std::vector<int> next_;
+        std::vector<float> cost_;
+
+        // Queue of the search, kept to reuse its memory
+        QuadHeap heap_;
+
+        // Statistics of the last build
+        SearchStats stats_;
+};
+
+} // namespace game
+
+#endif // FLOW_FIELD_H_
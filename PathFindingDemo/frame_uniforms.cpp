@@ -0,0 +1,40 @@
+#include <cstring>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "shader.h"
+#include "frame_uniforms.h"
+
+namespace game {
+
+FrameUniforms::FrameUniforms(void)
+{
+    // Don't do work in the constructor, leave it for the Init() function
+    ubo_ = 0;
+}
+
+
+void FrameUniforms::Init(void)
+{
+
+    // Allocate the buffer and attach it to the binding point that the
+    // shaders read their FrameData block from
+    glGenBuffers(1, &ubo_);
+    glBindBuffer(GL_UNIFORM_BUFFER, ubo_);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameData), NULL, GL_DYNAMIC_DRAW);
+    glBindBufferBase(GL_UNIFORM_BUFFER, frame_data_binding_g, ubo_);
+}
+
+
+void FrameUniforms::Update(const glm::mat4 &view_matrix, float time)
+{
+
+    FrameData data;
+    memcpy(data.view_matrix, glm::value_ptr(view_matrix), sizeof(data.view_matrix));
+    data.time = time;
+    data.padding[0] = data.padding[1] = data.padding[2] = 0.0f;
+
+    glBindBuffer(GL_UNIFORM_BUFFER, ubo_);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameData), &data);
+}
+
+} // namespace game
@@ -0,0 +1,47 @@
+#ifndef FRAME_UNIFORMS_H_
+#define FRAME_UNIFORMS_H_
+
+#define GLEW_STATIC
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+namespace game {
+
+    // Constants shared by all shaders during a frame, kept in a uniform
+    // buffer that shaders read through their FrameData block:
+    //
+    //     layout(std140) uniform FrameData {
+    //         mat4 view_matrix;
+    //         float time;
+    //     };
+    //
+    // The buffer is uploaded once per frame instead of setting the same
+    // uniforms for every object that is drawn
+    class FrameUniforms {
+
+        public:
+            // Constructor
+            FrameUniforms(void);
+
+            // Create the buffer and bind it to frame_data_binding_g
+            // Needs an OpenGL context
+            void Init(void);
+
+            // Upload the constants of the new frame
+            void Update(const glm::mat4 &view_matrix, float time);
+
+        private:
+            // Contents of the buffer, following the std140 layout
+            struct FrameData {
+                GLfloat view_matrix[16];
+                GLfloat time;
+                GLfloat padding[3];
+            };
+
+            // Reference to the uniform buffer
+            GLuint ubo_;
+
+    }; // class FrameUniforms
+} // namespace game
+
+#endif // FRAME_UNIFORMS_H_
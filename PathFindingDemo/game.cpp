@@ -7,6 +7,7 @@
 
 #include <path_config.h>
 
+#include "gl_state.h"
 #include "sprite.h"
 #include "particles.h"
 #include "shader.h"
@@ -67,6 +68,9 @@ void Game::Init(void)
     // Set event callbacks
     glfwSetFramebufferSizeCallback(window_, ResizeCallback);
 
+    // Initialize the buffer of per-frame shader constants
+    frame_uniforms_.Init();
+
     // Initialize sprite geometry
     sprite_ = new Sprite();
     sprite_->CreateGeometry();
@@ -81,6 +85,9 @@ void Game::Init(void)
     // Initialize sprite shader
     sprite_shader_.Init((resources_directory_g+std::string("/sprite_vertex_shader.glsl")).c_str(), (resources_directory_g+std::string("/sprite_fragment_shader.glsl")).c_str());
 
+    // Initialize graph shader
+    graph_shader_.Init((resources_directory_g+std::string("/graph_vertex_shader.glsl")).c_str(), (resources_directory_g+std::string("/graph_fragment_shader.glsl")).c_str());
+
     // Initialize time
     current_time_ = 0.0;
 
@@ -136,7 +143,7 @@ void Game::Setup(void)
 #if GRAPH_OPTION == 1
 
     // Simple graph
-    g_.BuildSimpleGraph(node_sprite, edge_sprite);
+    g_.BuildSimpleGraph();
 
 #elif GRAPH_OPTION == 2
 
@@ -147,16 +154,19 @@ void Game::Setup(void)
     // So, we lay out the grid graph over this range
     // We add a small shift to start_x and start_y so that the graph is
     // not glued to the window's edge
-    g_.BuildGrid(18, 14, 0.5, 0.5, -4.25, 0.75, 4, node_sprite, edge_sprite);
+    g_.BuildGrid(18, 14, 0.5, 0.5, -4.25, 0.75, 4);
 
 #elif GRAPH_OPTION == 3
 
     // Grid graph + maze
     Graph temp;
-    temp.BuildGrid(18, 14, 0.5, 0.5, -4.25, 0.75, 4, node_sprite, edge_sprite);
-    g_.BuildEmptyGraph(node_sprite, edge_sprite);
+    temp.BuildGrid(18, 14, 0.5, 0.5, -4.25, 0.75, 4);
     temp.BuildMaze(g_);
 #endif
+
+    // Draw the graph with the sprites, all nodes and all edges in one
+    // call each
+    graph_view_.Attach(&g_, node_sprite, edge_sprite, &graph_shader_);
 }
 
 
@@ -171,7 +181,7 @@ void Game::ResizeCallback(GLFWwindow* window, int width, int height)
 void Game::SetTexture(GLuint w, const char *fname)
 {
     // Bind texture buffer
-    glBindTexture(GL_TEXTURE_2D, w);
+    GLState::BindTexture(w);
 
     // Load texture from a file to the buffer
     int width, height;
@@ -207,7 +217,7 @@ void Game::SetAllTextures(void)
         SetTexture(tex_[i], (resources_directory_g+std::string(texture[i])).c_str());
     }
     // Set first texture in the array as default
-    glBindTexture(GL_TEXTURE_2D, tex_[0]);
+    GLState::BindTexture(tex_[0]);
 }
 
 
@@ -293,7 +303,7 @@ void Game::Update(double delta_time)
     }
 
     // Update the graph
-    g_.Update(window_, camera_zoom_);
+    graph_view_.Update(window_, camera_zoom_);
 
     // Cool down for zoom
     time_since_last_zoom_ += delta_time;
@@ -324,13 +334,16 @@ void Game::Render(void){
     glm::mat4 camera_zoom_matrix = glm::scale(glm::mat4(1.0f), glm::vec3(camera_zoom_, camera_zoom_, camera_zoom_));
     glm::mat4 view_matrix = window_scale_matrix * camera_zoom_matrix;
 
+    // Upload the view matrix and the time once for all shaders
+    frame_uniforms_.Update(view_matrix, current_time_);
+
     // Render all game objects
     for (int i = 0; i < game_objects_.size(); i++) {
         game_objects_[i]->Render(view_matrix, current_time_);
     }
 
     // Render the graph
-    g_.Render(view_matrix, current_time_);
+    graph_view_.Render(view_matrix, current_time_);
 }
       
 } // namespace game
@@ -7,8 +7,10 @@
 #include <vector>
 
 #include "shader.h"
+#include "frame_uniforms.h"
 #include "game_object.h"
 #include "graph.h"
+#include "graph_view.h"
 
 namespace game {
 
@@ -46,6 +48,12 @@ namespace game {
             // Shader for rendering particles
             Shader particle_shader_;
 
+            // Shader for rendering all graph nodes or edges at once
+            Shader graph_shader_;
+
+            // Constants shared by the shaders during a frame
+            FrameUniforms frame_uniforms_;
+
             // References to textures
             // This needs to be a pointer
             GLuint *tex_;
@@ -66,6 +74,9 @@ namespace game {
             // Graph for traversal of game world
             Graph g_;
 
+            // Display of the graph
+            GraphView graph_view_;
+
             // Callback for when the window is resized
             static void ResizeCallback(GLFWwindow* window, int width, int height);
 
@@ -2,6 +2,7 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <iostream>
 
+#include "gl_state.h"
 #include "game_object.h"
 
 namespace game {
@@ -16,6 +17,8 @@ GameObject::GameObject(const glm::vec3 &position, Geometry *geom, Shader *shader
     geometry_ = geom;
     shader_ = shader;
     texture_ = texture;
+    transformation_matrix_location_ = shader->GetUniformLocation("transformation_matrix");
+    color_mod_location_ = shader->GetUniformLocation("color_mod");
 }
 
 
@@ -67,11 +70,9 @@ void GameObject::Update(double delta_time) {
 void GameObject::Render(glm::mat4 view_matrix, double current_time){
 
     // Set up the shader
+    // The view matrix is read from the frame uniforms
     shader_->Enable();
 
-    // Set up the view matrix
-    shader_->SetUniformMat4("view_matrix", view_matrix);
-
     // Setup the scaling matrix for the shader
     glm::mat4 scaling_matrix = glm::scale(glm::mat4(1.0f), glm::vec3(scale_, scale_, 1.0));
 
@@ -85,16 +86,16 @@ void GameObject::Render(glm::mat4 view_matrix, double current_time){
     glm::mat4 transformation_matrix = translation_matrix * rotation_matrix * scaling_matrix;
 
     // Set the transformation matrix in the shader
-    shader_->SetUniformMat4("transformation_matrix", transformation_matrix);
+    shader_->SetUniformMat4(transformation_matrix_location_, transformation_matrix);
 
     // Set up the geometry
-    geometry_->SetGeometry(shader_->GetShaderProgram());
+    geometry_->SetGeometry(shader_);
 
     // Bind the entity's texture
-    glBindTexture(GL_TEXTURE_2D, texture_);
+    GLState::BindTexture(texture_);
 
     // Set the color modifier
-    shader_->SetUniform3f("color_mod", color_mod_);
+    shader_->SetUniform3f(color_mod_location_, color_mod_);
 
     // Draw the entity
     glDrawElements(GL_TRIANGLES, geometry_->GetSize(), GL_UNSIGNED_INT, 0);
@@ -18,6 +18,8 @@ namespace game {
 
         public:
             // Constructor
+            // The shader must be initialized before, since the locations
+            // of its uniforms are looked up here
             GameObject(const glm::vec3 &position, Geometry *geom, Shader *shader, GLuint texture);
 
             // Update the GameObject's state. Can be overriden in children
@@ -30,6 +32,8 @@ namespace game {
             inline glm::vec3 GetPosition(void) const { return position_; }
             inline float GetScale(void) const { return scale_; }
             inline float GetRotation(void) const { return angle_; }
+            inline Geometry *GetGeometry(void) const { return geometry_; }
+            inline GLuint GetTexture(void) const { return texture_; }
 
             // Get bearing direction (direction in which the game object
             // is facing)
@@ -60,8 +64,10 @@ namespace game {
             // Geometry
             Geometry *geometry_;
  
-            // Shader
+            // Shader, and the locations of the uniforms set by Render
             Shader *shader_;
+            GLint transformation_matrix_location_;
+            GLint color_mod_location_;
 
             // Object's texture reference
             GLuint texture_;
@@ -0,0 +1,68 @@
+#include "gl_state.h"
+#include "geometry.h"
+
+namespace game {
+
+Geometry::~Geometry(void)
+{
+
+    for (int i = 0; i < (int) vao_.size(); i++) {
+        glDeleteVertexArrays(1, &vao_[i].second);
+    }
+}
+
+
+void Geometry::SetGeometry(const Shader *shader)
+{
+
+    // The vertex array keeps the buffers and attributes, so they are only
+    // set the first time the shader is used
+    SetState();
+    if (BindVertexArray(shader->GetShaderProgram())) {
+        SetLayout(shader);
+    }
+}
+
+
+void Geometry::SetLayout(const Shader *shader)
+{
+
+    glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo_);
+    SetAttributes(shader);
+}
+
+
+bool Geometry::BindVertexArray(GLuint shader_program)
+{
+
+    // Few programs use the same geometry, so a linear search is enough
+    for (int i = 0; i < (int) vao_.size(); i++) {
+        if (vao_[i].first == shader_program) {
+            GLState::BindVertexArray(vao_[i].second);
+            return false;
+        }
+    }
+
+    // First use with this program: the layout set next is recorded in
+    // the new vertex array
+    GLuint vao;
+    glGenVertexArrays(1, &vao);
+    vao_.push_back(std::make_pair(shader_program, vao));
+    GLState::BindVertexArray(vao);
+    return true;
+}
+
+
+void Geometry::SetAttribute(const Shader *shader, const char *name, GLint size, int stride, int offset)
+{
+
+    GLint att = shader->GetAttribLocation(name);
+    if (att < 0) {
+        return;
+    }
+    glVertexAttribPointer(att, size, GL_FLOAT, GL_FALSE, stride * sizeof(GLfloat), (void *)(offset * sizeof(GLfloat)));
+    glEnableVertexAttribArray(att);
+}
+
+} // namespace game
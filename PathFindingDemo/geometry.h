@@ -3,6 +3,10 @@
 
 #define GLEW_STATIC
 #include <GL/glew.h>
+#include <utility>
+#include <vector>
+
+#include "shader.h"
 
 namespace game {
 
@@ -12,12 +16,21 @@ namespace game {
         public:
             // Constructor and destructor
             Geometry(void) {};
+            virtual ~Geometry(void);
 
             // Create the geometry (called once)
             virtual void CreateGeometry(void) {};
 
-            // Use the geometry
-            virtual void SetGeometry(GLuint shader_program) {};
+            // Use the geometry with a shader
+            void SetGeometry(const Shader *shader);
+
+            // Set the blending and depth test used to draw the geometry
+            virtual void SetState(void) {};
+
+            // Record the buffers and attributes of the geometry for a
+            // shader in the bound vertex array, so that a caller can add
+            // its own attributes to a vertex array of its own
+            void SetLayout(const Shader *shader);
 
             // Getter
             int GetSize(void) const { return size_; }
@@ -28,6 +41,23 @@ namespace game {
             GLuint ebo_;
             int size_;
 
+            // Set the attributes of the vertex buffer read by a shader
+            virtual void SetAttributes(const Shader *shader) {};
+
+            // Read a vertex attribute of the shader from the vertex buffer,
+            // with the stride and offset given in floats. Attributes that
+            // the shader does not use are skipped
+            void SetAttribute(const Shader *shader, const char *name, GLint size, int stride, int offset);
+
+        private:
+            // Vertex array of each shader program used with the geometry
+            std::vector<std::pair<GLuint, GLuint> > vao_;
+
+            // Bind the vertex array that records the attribute layout of
+            // the geometry for a shader program. Returns true if it was
+            // just created, in which case the layout must be set
+            bool BindVertexArray(GLuint shader_program);
+
     }; // class Geometry
 } // namespace game
 
@@ -0,0 +1,108 @@
+#include "gl_state.h"
+
+namespace game {
+
+// Invalid values, so that the first call to each setter reaches OpenGL
+GLuint GLState::program_ = (GLuint) -1;
+GLuint GLState::texture_ = (GLuint) -1;
+GLuint GLState::vao_ = (GLuint) -1;
+int GLState::blend_ = -1;
+GLenum GLState::src_factor_ = GL_NONE;
+GLenum GLState::dst_factor_ = GL_NONE;
+int GLState::depth_test_ = -1;
+GLenum GLState::depth_func_ = GL_NONE;
+
+
+void GLState::UseProgram(GLuint program)
+{
+
+    if (program != program_) {
+        glUseProgram(program);
+        program_ = program;
+    }
+}
+
+
+void GLState::BindTexture(GLuint texture)
+{
+
+    if (texture != texture_) {
+        glBindTexture(GL_TEXTURE_2D, texture);
+        texture_ = texture;
+    }
+}
+
+
+void GLState::BindVertexArray(GLuint vao)
+{
+
+    if (vao != vao_) {
+        glBindVertexArray(vao);
+        vao_ = vao;
+    }
+}
+
+
+void GLState::EnableBlend(GLenum src_factor, GLenum dst_factor)
+{
+
+    if (blend_ != 1) {
+        glEnable(GL_BLEND);
+        blend_ = 1;
+    }
+    if (src_factor != src_factor_ || dst_factor != dst_factor_) {
+        glBlendFunc(src_factor, dst_factor);
+        src_factor_ = src_factor;
+        dst_factor_ = dst_factor;
+    }
+}
+
+
+void GLState::DisableBlend(void)
+{
+
+    if (blend_ != 0) {
+        glDisable(GL_BLEND);
+        blend_ = 0;
+    }
+}
+
+
+void GLState::EnableDepthTest(GLenum func)
+{
+
+    if (depth_test_ != 1) {
+        glEnable(GL_DEPTH_TEST);
+        depth_test_ = 1;
+    }
+    if (func != depth_func_) {
+        glDepthFunc(func);
+        depth_func_ = func;
+    }
+}
+
+
+void GLState::DisableDepthTest(void)
+{
+
+    if (depth_test_ != 0) {
+        glDisable(GL_DEPTH_TEST);
+        depth_test_ = 0;
+    }
+}
+
+
+void GLState::Reset(void)
+{
+
+    program_ = (GLuint) -1;
+    texture_ = (GLuint) -1;
+    vao_ = (GLuint) -1;
+    blend_ = -1;
+    src_factor_ = GL_NONE;
+    dst_factor_ = GL_NONE;
+    depth_test_ = -1;
+    depth_func_ = GL_NONE;
+}
+
+} // namespace game
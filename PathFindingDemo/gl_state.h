@@ -0,0 +1,57 @@
+#ifndef GL_STATE_H_
+#define GL_STATE_H_
+
+#define GLEW_STATIC
+#include <GL/glew.h>
+
+namespace game {
+
+    // Tracker of the OpenGL state changed while drawing
+    //
+    // Each setter only calls OpenGL if the state differs from the last
+    // value it set, which removes the redundant calls made when many
+    // objects share a shader, a texture or a blend mode. The state must
+    // only be changed through this class, or Reset() must be called
+    // after changing it directly
+    class GLState {
+
+        public:
+            // Use a shader program
+            static void UseProgram(GLuint program);
+
+            // Bind a 2D texture to the active texture unit
+            static void BindTexture(GLuint texture);
+
+            // Bind a vertex array object
+            static void BindVertexArray(GLuint vao);
+
+            // Enable blending with the given factors, or disable it
+            static void EnableBlend(GLenum src_factor, GLenum dst_factor);
+            static void DisableBlend(void);
+
+            // Enable depth testing with the given comparison, or disable it
+            static void EnableDepthTest(GLenum func);
+            static void DisableDepthTest(void);
+
+            // Forget the tracked state, so that the next setters call
+            // OpenGL again
+            static void Reset(void);
+
+        private:
+            // Current program, texture and vertex array
+            static GLuint program_;
+            static GLuint texture_;
+            static GLuint vao_;
+
+            // Blending: -1 if unknown, 0 if disabled, 1 if enabled
+            static int blend_;
+            static GLenum src_factor_, dst_factor_;
+
+            // Depth test: -1 if unknown, 0 if disabled, 1 if enabled
+            static int depth_test_;
+            static GLenum depth_func_;
+
+    }; // class GLState
+} // namespace game
+
+#endif // GL_STATE_H_
@@ -1,46 +1,157 @@
-#include <glm/gtc/matrix_transform.hpp> 
-#include <queue>
 #include <algorithm>
+#include <new>
+#include <cstdlib>
 #include <iostream>   
 #include <stack>
+#include <climits>
+#include <stdexcept>
+#include <string>
+#include <chrono>
+#include <cmath>
 
 #include "graph.h"
+#include "dijkstra.h"
+#include "astar.h"
+#include "bidirectional_search.h"
 
 namespace game {
 
+// Largest edge cost for which searches use a bucket queue when all
+// costs are integers
+// Above this, the buckets take more memory than they save in time
+const int max_bucket_cost_g = 1024;
+
+
+// Get the work done by a search between two readings of its statistics
+static SearchStats StatsSince(const SearchStats &now, const SearchStats &before){
+
+    SearchStats stats = {now.pushes - before.pushes, now.pops - before.pops, now.stale_pops - before.stale_pops, now.expanded - before.expanded};
+    return stats;
+}
+
+
 Graph::Graph(void){
 
     // Initialize all members to default values
-    node_obj_ = NULL;
-    edge_obj_ = NULL;
     start_node_ = NULL;
     end_node_ = NULL;
-    hover_node_ = NULL;
+    compiled_ = false;
+    edge_capacity_ = 0;
+    heuristic_type_ = HEURISTIC_EUCLIDEAN;
+    bidirectional_ = false;
+    grid_cols_ = 0;
+    grid_rows_ = 0;
+    path_start_ = -1;
+    path_end_ = -1;
+    last_query_start_ = -1;
+    stats_ = SearchStats();
+    pending_start_ = -1;
+    pending_end_ = -1;
+    next_start_ = -1;
+    next_end_ = -1;
+    step_expansions_ = 0;
+    step_microseconds_ = 0;
+    incremental_ = false;
+    version_ = 0;
+    layout_version_ = 0;
+    path_version_ = 0;
+}
+
+
+Graph::~Graph(){
+
+    // Let a running search finish before the graph goes away
+    // The arena then releases all nodes and edges, and nodes have
+    // nothing else to free
+    CancelRequests();
 }
 
 
 Node *Graph::AddNode(int id, float x, float y){
 
-    // Create and add new node to the graph
-    Node *node = new Node(id, x, y);
+    // Searches in the background read the list of nodes and the flags
+    // below
+    CancelRequests();
+
+    // Create and add new node to the graph, in the memory of the arena
+    // Its edges come from a separate arena, released by Compile()
+    Node *node = new (arena_.Allocate<Node>(1)) Node(id, x, y, &edge_arena_, edge_capacity_);
     node_.push_back(node);
+    spatial_index_.Insert(node_.size() - 1, x, y);
+
+    // The compact representation no longer matches the graph
+    compiled_ = false;
+    version_++;
+    layout_version_++;
     return node;
 }
 
 
-void Graph::BuildEmptyGraph(GameObject *node_sprite, GameObject *edge_sprite){
+void Graph::SetPosition(int index, float x, float y){
+
+    // Searches in the background read the compact graph
+    CancelRequests();
+    node_[index]->SetPosition(x, y);
+    spatial_index_.Move(index, x, y);
 
-    // Set sprite game objects
-    node_obj_ = node_sprite;
-    edge_obj_ = edge_sprite;
+    // The distance estimate and the cached paths depend on the positions
+    compiled_ = false;
+    path_start_ = -1;
+    path_end_ = -1;
+    version_++;
+    layout_version_++;
 }
 
 
-void Graph::BuildSimpleGraph(GameObject *node_sprite, GameObject *edge_sprite){
+void Graph::Reserve(int num_nodes, int num_edges){
 
-    // Set sprite game objects
-    node_obj_ = node_sprite;
-    edge_obj_ = edge_sprite;
+    // Searches in the background read the list of nodes, which may be
+    // reallocated
+    CancelRequests();
+    node_.reserve(node_.size() + num_nodes);
+    arena_.Reserve(num_nodes*sizeof(Node));
+
+    // Give each node an equal slice of the edges
+    edge_capacity_ = num_nodes > 0 ? (num_edges + num_nodes - 1)/num_nodes : 0;
+    edge_arena_.Reserve((size_t) num_nodes*edge_capacity_*sizeof(Edge));
+}
+
+
+void Graph::Clear(void){
+
+    CancelRequests();
+
+    // Drop everything that refers to the nodes
+    start_node_ = NULL;
+    end_node_ = NULL;
+    path_node_.clear();
+    on_path_.clear();
+    marked_node_.clear();
+    path_version_++;
+    path_start_ = -1;
+    path_end_ = -1;
+    last_query_start_ = -1;
+    csr_.Clear();
+    jps_.Clear();
+    ch_.Clear();
+    dstar_.Clear();
+    tree_.Clear();
+    compiled_ = false;
+    grid_cols_ = 0;
+    grid_rows_ = 0;
+    version_++;
+    layout_version_++;
+
+    // Release the nodes and edges in one go
+    node_.clear();
+    arena_.Clear();
+    edge_arena_.Clear();
+    edge_capacity_ = 0;
+    spatial_index_.Clear();
+}
+
+
+void Graph::BuildSimpleGraph(void){
 
     // Create a graph with only five nodes
     Node *n0 = AddNode(0, -2.0, 0.0);
@@ -59,16 +170,23 @@ void Graph::BuildSimpleGraph(GameObject *node_sprite, GameObject *edge_sprite){
     SetStartNode(n0);
     SetEndNode(n4);
 
+    // Freeze the graph for path finding
+    Compile();
+
     // Find shortest path between nodes
     FindPath();
 }
 
 
-void Graph::BuildGrid(int cols, int rows, float disp_x, float disp_y, float start_x, float start_y, float viewport_height, GameObject *node_sprite, GameObject *edge_sprite){
+void Graph::BuildGrid(int cols, int rows, float disp_x, float disp_y, float start_x, float start_y, float viewport_height){
 
-    // Set sprite game objects
-    node_obj_ = node_sprite;
-    edge_obj_ = edge_sprite;
+    // Remember the layout for grid-specific searches
+    grid_cols_ = cols;
+    grid_rows_ = rows;
+
+    // Allocate all nodes and edges at once
+    // Every node has at most four neighbors
+    Reserve(rows*cols, 4*rows*cols);
 
     // Add nodes in a grid layout
     int id = 0;
@@ -118,6 +236,13 @@ void Graph::BuildGrid(int cols, int rows, float disp_x, float disp_y, float star
     SetStartNode(node_[0]);
     SetEndNode(node_[rows*cols-1]);
 
+    // Nodes are only connected horizontally and vertically, so the
+    // Manhattan distance is the tightest estimate
+    SetHeuristic(HEURISTIC_MANHATTAN);
+
+    // Freeze the graph for path finding
+    Compile();
+
     // Find shortest path between nodes
     FindPath();
 }
@@ -126,302 +251,513 @@ void Graph::BuildGrid(int cols, int rows, float disp_x, float disp_y, float star
 void Graph::PrintData() {
 
     // Loop through array and print out data for each node
-    for (int i = 0; i < node_.size(); i++) {
-        std::cout << "Node " << i << ": id: " << node_[i]->GetId() << ", x: " << node_[i]->GetX() << ", y: " << node_[i]->GetY() << ", number of neighbors: " << node_[i]->GetNumEdges() << std::endl;
+    // The edges are counted in the compact graph
+    const CsrGraph &csr = GetCompiledGraph();
+    for (size_t i = 0; i < node_.size(); i++) {
+        std::cout << "Node " << i << ": id: " << node_[i]->GetId() << ", x: " << node_[i]->GetX() << ", y: " << node_[i]->GetY() << ", number of neighbors: " << csr.EdgeEnd(i) - csr.EdgeBegin(i) << std::endl;
     }
 }
 
 
-void Graph::Update(GLFWwindow *window, float zoom){
-
-    // Get mouse pixel position in the window
-    double xpos, ypos;
-    glfwGetCursorPos(window, &xpos, &ypos);
+void Graph::Compile(void){
 
-    // Get information about the window
-    int width, height;
-    glfwGetWindowSize(window, &width, &height);
+    // Searches in the background read the compact graph
+    CancelRequests();
 
-    // Find node at the given pixel position
-    Node *n = SelectNode(xpos, ypos, width, height, zoom);
+    // Move the new edges of the nodes into the contiguous arrays, which
+    // then hold the only copy of the edges
+    csr_.Build(node_);
+    for (size_t i = 0; i < node_.size(); i++){
+        node_[i]->ReleaseEdges();
+    }
+    edge_arena_.Clear();
+    edge_capacity_ = 0;
+    compiled_ = true;
+    version_++;
+    layout_version_++;
+
+    // Scale the distance estimate for the new graph
+    heuristic_ = Heuristic::ForGraph(csr_, heuristic_type_);
+
+    // Prepare Jump Point Search with precomputed jumps (JPS+) if the
+    // graph is a grid with uniform costs
+    // Otherwise the search is left not ready
+    jps_.Build(csr_, grid_cols_, grid_rows_, true);
+
+    // The hierarchy, the incremental search, the tree and the marked
+    // path of the previous graph are no longer valid
+    ch_.Clear();
+    dstar_.Clear();
+    tree_.Clear();
+    path_start_ = -1;
+    path_end_ = -1;
+}
 
-    // Set the hover node to this node
-    // It is fine if the node is NULL
-    hover_node_ = n;
 
-    // Check mouse clicks
-    if (glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS){
-        
-        // Set the start to selected node, if node exists and is not the end-node
-        if (n != NULL && n != end_node_) {
-            SetStartNode(n);
-        }
+void Graph::BuildHierarchy(void){
 
-        // Find a path between currently selected nodes
-        FindPath();
+    if (!compiled_){
+        Compile();
     }
+    CancelRequests();
+    ch_.Build(csr_);
+}
 
-    if (glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_RIGHT) == GLFW_PRESS) {
 
-        // Set the end to selected node, if node exists and is not the start-node
-        if (n != NULL && n != start_node_) {
-            SetEndNode(n);
-        }
+void Graph::SetHeuristic(HeuristicType type){
 
-        // Find a path between currently selected nodes
-        FindPath();
+    CancelRequests();
+    dstar_.Clear();
+    heuristic_type_ = type;
+    if (compiled_){
+        heuristic_ = Heuristic::ForGraph(csr_, heuristic_type_);
     }
 }
 
 
-Node *Graph::SelectNode(double x, double y, int window_width, int window_height, float camera_zoom){
+void Graph::FindPath(void){
 
-    // If the mouse is outside the window, return NULL
-    if (x < 0 || x > window_width || y < 0 || y > window_height) {
-        return NULL;
+    // Make sure the search runs on an up-to-date graph, and that an
+    // older request cannot replace the path afterwards
+    if (!compiled_){
+        Compile();
     }
+    CancelRequests();
 
-    // Get position in world coordinates corresponding to the mouse
-    // pixel position on the window
-    float w = window_width;
-    float h = window_height;
-    float cursor_x_pos = 0.0;
-    float cursor_y_pos = 0.0;
-    if (w > h){
-        float aspect_ratio = w/h;
-        cursor_x_pos = ((2.0f*x - w)*aspect_ratio)/(w*camera_zoom);
-        cursor_y_pos = (-2.0f*y + h)/(h*camera_zoom);
-    } else {
-        float aspect_ratio = h/w;
-        cursor_x_pos = (2.0f*x - w)/(w*camera_zoom);
-        cursor_y_pos = ((-2.0f*y + h)*aspect_ratio)/(h*camera_zoom);
-    }
-
-    // Find node at the derived position
-    // This is done in a brute-force manner by checking each node, and
-    // can be improved with spatial query structures
-    float node_scale = node_obj_->GetScale();
-    for (int i = 0; i < node_.size(); i++){
-        // Check if mouse is inside a ball of radius scale*scale
-        glm::vec2 center(node_[i]->GetX(), node_[i]->GetY());
-        glm::vec2 cursor(cursor_x_pos, cursor_y_pos);
-        if (glm::length(cursor - center) < node_scale*node_scale){
-            return node_[i];
+    // Nothing changed since the marked path was found
+    int start = start_node_->GetId();
+    int end = end_node_->GetId();
+    if (start == path_start_ && end == path_end_) {
+        return;
+    }
+
+    // The statistics only count the work done for this query
+    std::vector<int> path;
+    bool found;
+    float cost = INFINITY;
+    bool repeated = start == last_query_start_;
+    last_query_start_ = start;
+    if (incremental_) {
+        SearchStats before = dstar_.IsStarted() && dstar_.GetGoal() == end ? dstar_.GetStats() : SearchStats();
+        RepairPath(start, end, path, cost);
+        stats_ = StatsSince(dstar_.GetStats(), before);
+    } else if (cache_.Find(start, end, version_, found, path, cost)) {
+        // The route was found before on the same graph, without a search
+        stats_ = SearchStats();
+    } else if (!ch_.IsReady() && (tree_.IsRootedAt(start) || repeated)) {
+        // The start node repeats, so read the path from its tree, which
+        // pays off over the next queries from the same start. The first
+        // query from a start runs a regular search instead, and a query
+        // on the hierarchy is always cheaper than growing the tree
+        SearchStats before = tree_.IsRootedAt(start) ? tree_.GetStats() : SearchStats();
+        if (!tree_.IsRootedAt(start)) {
+            tree_.Start(csr_, start);
+        }
+        found = tree_.Settle(end);
+        if (found) {
+            tree_.GetPath(end, path);
+            cost = tree_.GetCost(end);
         }
+        stats_ = StatsSince(tree_.GetStats(), before);
+        cache_.Insert(start, end, version_, found, path, cost);
+    } else {
+        // Run the search with the state owned by the graph
+        found = SearchPath(start, end, context_, path, cost);
+        stats_ = context_.GetStats();
+        cache_.Insert(start, end, version_, found, path, cost);
     }
+    MarkPath(start, end, path);
 
-    // Return NULL by default (no node found)
-    return NULL;
+    // Uncomment to see the ids in order on the path 
+    ///for (Node *ele : path_node_) {
+    //    std::cout << "id:" << ele->GetId() << std::endl;
+    //}/
 }
 
 
-void Graph::Render(glm::mat4 view_matrix, double current_time){
-
-    // First, render all the nodes in the graph so that they appear on
-    // top of the edges
-    //
-    // Go through each node and render it using the provided game object
-    for (int i = 0; i < node_.size(); i++) {
-        
-        // Get the current node to draw
-        Node *current_node = node_[i];
-
-        // Set the position of the sprite with the position of the node
-        glm::vec3 pos(current_node->GetX(), current_node->GetY(), 0.0f);
-        node_obj_->SetPosition(pos);
-        
-        // Set the color of the node via the color modifier uniform
-        // The default color is green
-        node_obj_->SetColorModifier(glm::vec3(0.0f, 0.6f, 0.0f)); // Dark green
-
-        // Change the color modifier uniform depending on whether the
-        // node is the start or end node of the path, a node in the
-        // middle of the path, or the mouse is hovering over the node
-        if (current_node == start_node_) {
-            node_obj_->SetColorModifier(glm::vec3(1.0f, 0.0f, 0.0f)); // Red
-        } else if (current_node == end_node_) {
-            node_obj_->SetColorModifier(glm::vec3(0.0f, 0.0f, 1.0f)); // Blue
-        } else if (current_node == hover_node_) {
-            node_obj_->SetColorModifier(glm::vec3(1.0f, 0.6f, 1.0f)); // Pink
-        } else if (current_node->IsOnPath()) {
-            node_obj_->SetColorModifier(glm::vec3(0.0f, 1.0f, 0.0f)); // Light green
+bool Graph::HasEdge(int a, int b){
+
+    for (int i = 0; i < node_[a]->GetNumEdges(); i++) {
+        if (node_[a]->GetEdge(i).n2 == node_[b]) {
+            return true;
         }
-        
-        // Render the game object for the current node
-        node_obj_->Render(view_matrix, current_time);
-    }
-
-    // Now, render all the edges in the graph
-    for (int i = 0; i < node_.size(); i++) {
-        
-        // Get the current node to draw
-        Node *current_node = node_[i];
-
-        // Render the edges of this node
-        for (int i = 0; i < current_node->GetNumEdges(); i++) {
-            // Get pointer to neighbor edge
-            const Edge edge = current_node->GetEdge(i);
-            Node *neigh = edge.n2;
-
-            // Set the position of the edge sprite between the current
-            // node and its neighbor
-            glm::vec3 pos((current_node->GetX() + neigh->GetX())/2.0, 
-                          (current_node->GetY() + neigh->GetY())/2.0, 0.0f);
-            edge_obj_->SetPosition(pos);
-
-            // Check if the edge needs to be rotated
-            if ((neigh->GetY() > current_node->GetY()) || 
-                (neigh->GetY() < current_node->GetY())){
-                edge_obj_->SetRotation(glm::pi<float>()/2.0);
-            } else {
-                edge_obj_->SetRotation(0.0);
+    }
+    if (a < csr_.GetNumNodes() && b < csr_.GetNumNodes()) {
+        for (uint32_t e = csr_.EdgeBegin(a); e < csr_.EdgeEnd(a); e++) {
+            if (csr_.GetTarget(e) == b) {
+                return true;
             }
+        }
+    }
+    return false;
+}
 
-            // Set the color of the edge via the color modifier uniform
-            // Default color
-            edge_obj_->SetColorModifier(glm::vec3(0.0f, 0.6f, 0.0f)); // Dark green
 
-            // Change the color modifier uniform depending on whether
-            // the edge is on the path or not
-            if (current_node->IsOnPath() && neigh->IsOnPath()) {
-                edge_obj_->SetColorModifier(glm::vec3(0.0f, 1.0f, 0.0f)); // Lighter green
-            }
+void Graph::MarkPath(int start, int end, const std::vector<int> &path){
 
-            // Render the game object for the current edge
-            edge_obj_->Render(view_matrix, current_time);
-        }
+    // Reset the nodes of the previous path to be off-path, so that the
+    // cost does not depend on the size of the graph
+    if (on_path_.size() != node_.size()) {
+        on_path_.assign(node_.size(), false);
+    }
+    for (size_t i = 0; i < marked_node_.size(); i++) {
+        on_path_[marked_node_[i]] = false;
+    }
+    marked_node_.clear();
+
+    // Clear current path
+    path_node_.clear();
+
+    // Mark the nodes on the path
+    for (size_t i = 0; i < path.size(); i++) {
+        path_node_.push_back(node_[path[i]]);
     }
+    marked_node_ = path;
+
+    // Also set the start and end nodes to be on the path for display
+    // purposes
+    marked_node_.push_back(start);
+    marked_node_.push_back(end);
+    for (size_t i = 0; i < marked_node_.size(); i++) {
+        on_path_[marked_node_[i]] = true;
+    }
+    path_start_ = start;
+    path_end_ = end;
+    path_version_++;
 }
 
 
-// Structure used for ranking nodes in the priority queue
-// Declared here as it is only used in the FindPath() method below
-struct QNode{
-    Node *node; // Pointer to node
-    float cost; // Cost of node
-};
+void Graph::RequestPath(void){
 
+    if (start_node_ == NULL || end_node_ == NULL) {
+        return;
+    }
+    if (!compiled_){
+        Compile();
+    }
+    int start = start_node_->GetId();
+    int end = end_node_->GetId();
+
+    // With a search budget, start a search that UpdatePath() advances,
+    // replacing the one that is running
+    if ((step_expansions_ > 0 || step_microseconds_ > 0) && !incremental_) {
+        if (stepped_.IsRunning() && start == stepped_.GetStart() && end == stepped_.GetEnd()) {
+            return;
+        }
+        stepped_.Cancel();
+        if (start != path_start_ || end != path_end_) {
+            stepped_.Start(csr_, start, end, heuristic_);
+        }
+        return;
+    }
 
-// Class used for comparing two QNode structures
-class CompareNode
-{
-    public:
-        int operator() (const QNode& n1, const QNode& n2)
-        {
-            return n1.cost > n2.cost;
+    // While a search runs, only remember the latest request, which
+    // replaces any request that was already waiting
+    if (pending_.valid()) {
+        if (start == pending_start_ && end == pending_end_) {
+            next_start_ = -1;
+            next_end_ = -1;
+        } else {
+            next_start_ = start;
+            next_end_ = end;
         }
-};
+        return;
+    }
 
+    // Nothing to do if the marked path already joins the two nodes
+    if (start == path_start_ && end == path_end_) {
+        return;
+    }
 
+    // The path is known at once if it is in the cache, or if the tree
+    // of the start node reaches the end node. Incremental searches keep
+    // repairing their own state instead
+    std::vector<int> path;
+    bool found;
+    float cost;
+    if (!incremental_ && cache_.Find(start, end, version_, found, path, cost)) {
+        MarkPath(start, end, path);
+        return;
+    }
+    if (!incremental_ && tree_.IsRootedAt(start) && tree_.IsSettled(end)) {
+        tree_.GetPath(end, path);
+        MarkPath(start, end, path);
+        return;
+    }
+    SubmitRequest(start, end);
+}
 
-void Graph::FindPath(void){
 
-    // Initialize the priority queue used in path finding
-    // It is created using the QNode struct with a min compare class called CompareNode
-    std::priority_queue<QNode, std::vector<QNode>, CompareNode> pq;
-    // Clear current path
-    path_node_.clear();
-    // Set the costs of all nodes to infinity
-    // Reset all nodes to be off-path
-    for (int i = 0; i < node_.size(); i++) {
-        node_[i]->SetCost(INT_MAX);
-        node_[i]->SetOnPath(false);
-    }
-
-    // The start node is added to the priority queue with cost 0
-    QNode temp = {start_node_, 0};
-    pq.push(temp);
-
-    // Set the cost of the starting node
-    start_node_->SetCost(0.0);
-    
-    // Now that the pq is initialized, we can start the algorithm
-    while (!pq.empty()) {
-        // Get the current lowest-cost node in the pq
-        QNode lowest = pq.top();
-
-        // Remove the lowest node from the queue after retrieving it
-        pq.pop(); 
-        
-        // If the current node is the end node, we are done
-        if (lowest.node == end_node_) {
-            break;
+bool Graph::UpdatePath(void){
+
+    // Advance the search run in steps, and mark its path once done
+    if (stepped_.IsRunning()) {
+        SearchStatus status = stepped_.Step(step_expansions_, step_microseconds_);
+        if (status == SEARCH_RUNNING) {
+            return false;
         }
+        std::vector<int> path;
+        if (status == SEARCH_FOUND) {
+            stepped_.GetPath(path);
+        }
+        cache_.Insert(stepped_.GetStart(), stepped_.GetEnd(), version_, status == SEARCH_FOUND, path, stepped_.GetCost());
+        MarkPath(stepped_.GetStart(), stepped_.GetEnd(), path);
+        return true;
+    }
+
+    // Check without waiting if the running search is done
+    if (!pending_.valid() || pending_.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        return false;
+    }
+    PathResult result = pending_.get();
+    pending_start_ = -1;
+    pending_end_ = -1;
+    MarkPath(result.start, result.end, result.path);
+
+    // Start the request that arrived in the meantime
+    if (next_start_ != -1) {
+        SubmitRequest(next_start_, next_end_);
+        next_start_ = -1;
+        next_end_ = -1;
+    }
+    return true;
+}
 
-        // Otherwise, check the neighbors of the lowest node
-        for (int i = 0; i < lowest.node->GetNumEdges(); i++){
-
-            // Compute cost to get to neighbouring node
-            // cost = the cost to get the current node + cost to traverse the edge
-            const Edge edge = lowest.node->GetEdge(i);
-            Node *n = edge.n2;
-            float node_cost = lowest.cost + edge.cost;
-
-            // If the new cost is smaller than the current node cost,
-            // update the node cost, and add an updated QNode to the pq
-            if (node_cost < n->GetCost()){
-                // Update node cost
-                n->SetCost(node_cost);    
-
-                // Update the shortest path to the node
-                n->SetPrev(lowest.node);
-                
-                // Add zombie node to update value of node in the queue
-                QNode updated_node = {n, node_cost};
-                pq.push(updated_node);
+
+void Graph::SetEdgeCost(int a, int b, float cost){
+
+    if (a < 0 || b < 0 || a >= (int) node_.size() || b >= (int) node_.size()) {
+        throw(std::invalid_argument(std::string("Edge cost set for a node that is not in the graph")));
+    }
+    if (!(cost >= 0.0f)) {
+        throw(std::invalid_argument(std::string("Edge costs cannot be negative")));
+    }
+    if (!HasEdge(a, b)) {
+        throw(std::invalid_argument(std::string("Edge cost set for nodes that are not connected")));
+    }
+
+    // Searches in the background read the compact graph
+    CancelRequests();
+
+    // The edges are either still in the nodes, if added since the last
+    // Compile(), or already in the compact graph, which is updated in
+    // place
+    node_[a]->SetEdgeCost(node_[b], cost);
+    if (a < csr_.GetNumNodes() && b < csr_.GetNumNodes()) {
+        for (uint32_t e = csr_.EdgeBegin(a); e < csr_.EdgeEnd(a); e++) {
+            if (csr_.GetTarget(e) == b) {
+                csr_.SetCost(e, cost);
+            }
+        }
+        for (uint32_t e = csr_.EdgeBegin(b); e < csr_.EdgeEnd(b); e++) {
+            if (csr_.GetTarget(e) == a) {
+                csr_.SetCost(e, cost);
             }
         }
+    }
 
+    // The marked path and the cached ones may no longer be the shortest,
+    // so the next request has to search again
+    path_start_ = -1;
+    path_end_ = -1;
+    version_++;
+    if (!compiled_) {
+        return;
     }
+    jps_.Clear();
+    ch_.Clear();
+    tree_.Clear();
+
+    // Lower the scale of the estimate if the new cost would make it
+    // overestimate, which also invalidates the incremental search.
+    // Otherwise, let the incremental search repair its costs
+    float d = Heuristic::Distance(heuristic_.GetType(), csr_.GetX(b) - csr_.GetX(a), csr_.GetY(b) - csr_.GetY(a));
+    if (cost < heuristic_.GetScale()*d) {
+        heuristic_ = Heuristic::ForGraph(csr_, heuristic_type_);
+        dstar_.Clear();
+    } else if (dstar_.IsStarted()) {
+        dstar_.UpdateEdge(a, b);
+    }
+}
+
 
-    // Queue is done, go in reverse from END to START to determine path
-    Node* current_node = end_node_->GetPrev();
-    
-    // While the current node isn't null, or the end, mark the current
-    // node as on the path
-    path_node_.push_back(end_node_);
-    while (current_node != NULL && current_node != start_node_) {
-        path_node_.push_back(current_node);
-        current_node->SetOnPath(true);
-        current_node = current_node->GetPrev();
+void Graph::SetSearchBudget(int max_expansions, int max_microseconds){
+
+    CancelRequests();
+    step_expansions_ = max_expansions;
+    step_microseconds_ = max_microseconds;
+}
+
+
+void Graph::CancelRequests(void){
+
+    stepped_.Cancel();
+    if (pending_.valid()) {
+        pending_.wait();
+        pending_ = std::future<PathResult>();
     }
-    path_node_.push_back(current_node);
-    // Reverse path to get the order from start to end
-    std::reverse(path_node_.begin(), path_node_.end());
+    pending_start_ = -1;
+    pending_end_ = -1;
+    next_start_ = -1;
+    next_end_ = -1;
+}
 
-    // Also set the start and end nodes to be on the path for display
-    // purposes
-    start_node_->SetOnPath(true);
-    end_node_->SetOnPath(true);
 
-    // Uncomment to see the ids in order on the path 
-    ///for (Node *ele : path_node_) {
-    //    std::cout << "id:" << ele->GetId() << std::endl;
-    //}/
+bool Graph::RepairPath(int start, int end, std::vector<int> &path, float &cost){
+
+    // Repair the previous search if it has the same end node, after
+    // moving its start node if needed
+    if (!dstar_.IsStarted() || dstar_.GetGoal() != end) {
+        dstar_.Start(csr_, start, end, heuristic_);
+    } else if (dstar_.GetStart() != start) {
+        dstar_.MoveStart(start);
+    }
+    return dstar_.FindPath(path, cost);
+}
+
+
+void Graph::SubmitRequest(int start, int end){
+
+    // The background thread is only started by graphs that use it
+    if (!async_) {
+        async_.reset(new AsyncSearch());
+    }
+
+    // The engine of the incremental search is only used by one request
+    // at a time, since every change to the graph waits for the request
+    // first
+    if (incremental_) {
+        pending_ = async_->Submit(start, end, [this](int start, int end, SearchContext &, std::vector<int> &path, float *cost){
+            return RepairPath(start, end, path, *cost);
+        });
+    } else {
+        pending_ = async_->Submit(*this, start, end);
+    }
+    pending_start_ = start;
+    pending_end_ = end;
+}
+
+
+bool Graph::FindPath(int start, int end, SearchContext &context, std::vector<int> &path, float *cost) const {
+
+    // The search only reads the compact graph, so it has to be ready
+    if (!compiled_){
+        throw(std::runtime_error(std::string("Graph needs to be compiled before searching")));
+    }
+
+    // Hot routes are copied from the cache without any search
+    bool found;
+    float path_cost = INFINITY;
+    if (!cache_.Find(start, end, version_, found, path, path_cost)) {
+        found = SearchPath(start, end, context, path, path_cost);
+        cache_.Insert(start, end, version_, found, path, path_cost);
+    }
+    if (found && cost != NULL) {
+        *cost = path_cost;
+    }
+    return found;
+}
+
+
+void Graph::BuildFlowField(int goal, FlowField<CsrGraph> &field) const {
+
+    if (!compiled_){
+        throw(std::runtime_error(std::string("Graph needs to be compiled before building a flow field")));
+    }
+    field.Build(csr_, goal);
+}
+
+
+void Graph::FindDistances(DistanceTable &table, const int *sources, int num_sources, const int *targets, int num_targets, std::vector<int> *paths, float *costs) const {
+
+    if (!compiled_){
+        throw(std::runtime_error(std::string("Graph needs to be compiled before searching")));
+    }
+    if (ch_.IsReady()) {
+        table.Compute(ch_, sources, num_sources, targets, num_targets, paths, costs);
+    } else {
+        table.Compute(csr_, sources, num_sources, targets, num_targets, paths, costs);
+    }
+}
+
+
+bool Graph::SearchPath(int start, int end, SearchContext &context, std::vector<int> &path, float &cost) const {
+
+    path.clear();
+    bool found;
+    if (ch_.IsReady()) {
+        // The hierarchy answers queries on any graph while settling only
+        // a few nodes, so it takes precedence over the other searches
+        return ch_.FindPath(start, end, context, path, cost);
+    } else if (jps_.IsReady()) {
+        // On grids with uniform costs, Jump Point Search finds a path of
+        // the same cost while expanding far fewer nodes
+        return jps_.FindPath(start, end, context, path, cost);
+    } else if (bidirectional_) {
+        // Search from both ends, guided by the estimate if there is one
+        // The path is joined by the search itself
+        return BidirectionalSearch(csr_, start, end, heuristic_, context.GetHeap(), context.GetReverse().GetHeap(), context, path, cost);
+    } else if (heuristic_.GetType() != HEURISTIC_ZERO && csr_.HasIntegerCosts(max_bucket_cost_g)) {
+        // Run A* if a distance estimate is available, which expands far
+        // fewer nodes for point-to-point queries
+        // With small integer costs, such as the weights of a grid graph,
+        // the estimate is rounded down so that all keys are integers and
+        // the bucket queue of the context can be used
+        BucketQueue &buckets = context.GetBuckets();
+        buckets.SetMaxCost(2*csr_.GetMaxCost());
+        found = AStar(csr_, start, end, heuristic_.Floored(), buckets, context);
+    } else if (heuristic_.GetType() != HEURISTIC_ZERO) {
+        // Use the indexed heap for A* on other costs
+        found = AStar(csr_, start, end, heuristic_, context.GetHeap(), context);
+    } else if (csr_.HasIntegerCosts(max_bucket_cost_g)) {
+        // Otherwise, run Dijkstra's algorithm
+        // If all costs are small integers, such as the weights of a grid
+        // graph, use the bucket queue of the context since it takes
+        // constant time per operation
+        BucketQueue &buckets = context.GetBuckets();
+        buckets.SetMaxCost(csr_.GetMaxCost());
+        found = Dijkstra(csr_, start, end, buckets, context);
+    } else {
+        // Use the indexed heap so that no duplicate entries are created
+        found = Dijkstra(csr_, start, end, context.GetHeap(), context);
+    }
+    if (!found) {
+        return false;
+    }
+
+    // Go in reverse from END to START to determine path
+    context.GetPath(end, path);
+    cost = context.GetCost(end);
+    return true;
 }
 
 
 void Graph::BuildMaze(Graph& output){
 
     // Copy all the nodes to the output graph
-    for (int i = 0; i < node_.size(); i++) {
+    // The maze uses a subset of the edges of this graph, read from the
+    // compact graph
+    const CsrGraph &csr = GetCompiledGraph();
+    output.Reserve(node_.size(), csr.GetNumEdges());
+    for (size_t i = 0; i < node_.size(); i++) {
         output.AddNode(node_[i]->GetId(), node_[i]->GetX(), node_[i]->GetY());
     }
+    output.grid_cols_ = grid_cols_;
+    output.grid_rows_ = grid_rows_;
 
     // Perform a depth search to add edges to the output graph, creating
     // a maze structure in this process
 
     // Initialize all nodes as not visited
-    for (int i = 0; i < node_.size(); i++) {
-        node_[i]->SetVisited(false);
-    }
+    // Assumes the id of a node corresponds to its index
+    std::vector<bool> visited(node_.size(), false);
 
     // Initialize a stack
     std::stack<Node *> st;
 
     // Add the first node to the stack
     st.push(node_[0]);
-    node_[0]->SetVisited(true);
+    visited[0] = true;
 
     // Depth-first search
     while (st.size() > 0){
@@ -429,27 +765,26 @@ void Graph::BuildMaze(Graph& output){
         Node *n = st.top();
 
         // Create a randomized list of neighbors	
-        std::vector<int> index;
-        for (int i = 0; i < n->GetNumEdges(); i++) {
-            index.push_back(i);
+        std::vector<uint32_t> index;
+        for (uint32_t e = csr.EdgeBegin(n->GetId()); e < csr.EdgeEnd(n->GetId()); e++) {
+            index.push_back(e);
         }
         std::random_shuffle(index.begin(), index.end());
 
         // Find an unvisited neighbor
         bool found_unvisited = false;
-        for (int i = 0; i < index.size(); i++) {
-            const Edge edge = n->GetEdge(index[i]);
-            Node *neigh = edge.n2;
+        for (size_t i = 0; i < index.size(); i++) {
+            Node *neigh = node_[csr.GetTarget(index[i])];
 
-            if (!neigh->GetVisited()){
+            if (!visited[neigh->GetId()]){
                 // Add connection to unvisited neighbor in the output graph
                 // Assumes the id of a node corresponds to its index
                 Node *n1 = output.GetNode(n->GetId());
                 Node *n2 = output.GetNode(neigh->GetId());
-                n1->AddNeighbor(n2, edge.cost);
+                n1->AddNeighbor(n2, csr.GetCost(index[i]));
 
                 // Mark node as visited
-                neigh->SetVisited(true);
+                visited[neigh->GetId()] = true;
 
                 // Add neighbor to the stack
                 st.push(neigh);
@@ -471,6 +806,9 @@ void Graph::BuildMaze(Graph& output){
     output.SetStartNode(output.GetNode(0));
     output.SetEndNode(output.GetNode(output.GetNumNodes()-1));
 
+    // Freeze the output graph for path finding
+    output.Compile();
+
     // Find shortest path between nodes in the output graph
     output.FindPath();
 }
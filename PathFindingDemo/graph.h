@@ -1,57 +1,239 @@
 #ifndef GRAPH_H_
 #define GRAPH_H_
 
-#include <GL/glew.h> 
-#include <GLFW/glfw3.h>
-#include <glm/glm.hpp>
+#include <vector>
+#include <cstddef>
+#include <memory>
+#include <future>
 
 #include "node.h"
-#include "shader.h"
-#include "game_object.h"
+#include "csr_graph.h"
+#include "search_context.h"
+#include "heuristic.h"
+#include "jump_point_search.h"
+#include "contraction_hierarchy.h"
+#include "async_search.h"
+#include "resumable_search.h"
+#include "dstar_lite.h"
+#include "shortest_path_tree.h"
+#include "path_cache.h"
+#include "flow_field.h"
+#include "distance_table.h"
+#include "spatial_index.h"
 
 namespace game {
 
 // A graph with connected nodes
+//
+// The graph does not depend on OpenGL, so it can be used without a
+// display. The demo draws it and handles the mouse with a GraphView
 class Graph {
 
     public:
         // Lightweight constructor
         Graph(void);
 
+        // Release all the nodes and edges
+        ~Graph();
+
         // Add a node to the graph
         Node *AddNode(int id, float x, float y);
 
-        // Build an empty graph
-        void BuildEmptyGraph(GameObject *node_sprite, GameObject *edge_sprite);
+        // Move the node at the given index to position (x, y)
+        // Use this instead of Node::SetPosition, so that the spatial
+        // index follows the node. Compile() is then needed again, since
+        // the distance estimate of the search depends on the positions
+        void SetPosition(int index, float x, float y);
+
+        // Reserve memory for the given number of nodes and edges in one
+        // allocation each, before adding them. Each call to AddNeighbor
+        // creates two edges
+        // The nodes added next start with room for their share of the
+        // edges, taken from the reserved block, so that their edge
+        // arrays do not need to grow
+        void Reserve(int num_nodes, int num_edges);
+
+        // Remove all the nodes and edges and release their memory at once
+        void Clear(void);
+
+        // A graph owns its nodes, so it cannot be copied
+        Graph(const Graph &) = delete;
+        Graph &operator=(const Graph &) = delete;
 
         // Build a simple graph for demo purposes
-        void BuildSimpleGraph(GameObject *node_sprite, GameObject *edge_sprite);
+        void BuildSimpleGraph(void);
 
         // Build a graph with a grid layout
         // Parameters: columns and rows of the grid, displacement of
         // each node along x and y, starting x and y position, viewport
-        // height and sprite information
-        void BuildGrid(int cols, int rows, float disp_x, float disp_y, float start_x, float start_y, float viewport_height, GameObject *node_sprite, GameObject *edge_sprite);
+        // height
+        void BuildGrid(int cols, int rows, float disp_x, float disp_y, float start_x, float start_y, float viewport_height);
 
         // Print out associated data for each node in the graph
         void PrintData(void);
 
-        // Get mouse input, update start and end node, and compute
-        // shortest path between the two nodes
-        void Update(GLFWwindow *window, float zoom);
+        // Find the index of the node closest to (x, y) among the nodes
+        // closer than radius, or -1 if there is none
+        inline int FindNearestNode(float x, float y, float radius) const { return spatial_index_.FindNearest(x, y, radius); }
 
-        // Return the node at the (x, y) coordinate of the window
-        Node *SelectNode(double x, double y, int window_width, int window_height, float camera_zoom);
+        // Store in result the indices of the nodes closer than radius to
+        // (x, y), or inside the given rectangle, in increasing order
+        inline void FindNodesInRadius(float x, float y, float radius, std::vector<int> &result) const { spatial_index_.FindInRadius(x, y, radius, result); }
+        inline void FindNodesInRect(float min_x, float min_y, float max_x, float max_y, std::vector<int> &result) const { spatial_index_.FindInRect(min_x, min_y, max_x, max_y, result); }
 
         // Return the node at the given index
         inline Node *GetNode(int index) { return node_[index]; }
         inline int GetNumNodes(void) { return node_.size(); }
 
-        // Render all the nodes in the graph
-        void Render(glm::mat4 view_matrix, double current_time);
+        // Freeze the nodes and edges into the compact representation
+        // used by the path search
+        // Needs to be called again whenever nodes or edges are added
+        //
+        // The edges are moved out of the nodes, so afterwards they are
+        // only found in the compact representation, which takes about a
+        // third of their memory
+        //
+        // If the graph is a grid where all moves cost the same, this also
+        // prepares Jump Point Search, which FindPath then uses
+        void Compile(void);
+
+        // Preprocess the compiled graph into a Contraction Hierarchy,
+        // which FindPath then uses instead of the other searches
+        // This takes a while, but queries on large graphs become orders
+        // of magnitude faster. The hierarchy is dropped by Compile()
+        void BuildHierarchy(void);
+        inline bool HasHierarchy(void) const { return ch_.IsReady(); }
+
+        // Get the compact representation, compiling the graph first if
+        // nodes or edges were added
+        inline const CsrGraph &GetCompiledGraph(void) { if (!compiled_) { Compile(); } return csr_; }
+
+        // Get the compact representation as of the last compile, without
+        // compiling. It misses the nodes and edges added since, which the
+        // render path uses so that drawing never compiles the graph
+        inline const CsrGraph &GetLastCompiledGraph(void) const { return csr_; }
+        inline bool IsCompiled(void) const { return compiled_; }
 
         // Create and mark a path from start to end
+        //
+        // Nothing is done if the start and end nodes and the graph did
+        // not change since the marked path was found. When only the end
+        // node changed, the path comes from the shortest-path tree of
+        // the start node, which is grown only if the end node is not
+        // settled yet
         void FindPath(void);
+
+        // Start searching for a path from start to end on a background
+        // thread, and return at once. The current path stays marked
+        // until UpdatePath() picks up the new one
+        // Only the latest request is kept while a search is running,
+        // and nothing is done if the start and end nodes did not change
+        void RequestPath(void);
+
+        // Mark the path of the last finished request, if there is a new
+        // one, and start the latest request if it was waiting
+        // Returns true if the marked path changed
+        bool UpdatePath(void);
+
+        // Check if a requested path is still being searched
+        inline bool IsSearching(void) const { return pending_.valid() || stepped_.IsRunning(); }
+
+        // Run requested searches in steps on the calling thread instead
+        // of on a background thread. Each call to UpdatePath() then
+        // expands at most max_expansions nodes if it is positive, and
+        // stops after max_microseconds if it is positive, so that a long
+        // search is spread over several frames. Either limit alone, or
+        // both, can be given. The stepped search is A* with the selected
+        // heuristic. Setting both to 0 goes back to the background thread
+        void SetSearchBudget(int max_expansions, int max_microseconds);
+
+        // Select whether FindPath(void) repairs the previous path with
+        // D* Lite instead of searching from scratch. This pays off when
+        // edge costs change or the start node moves while the end node
+        // stays the same. RequestPath() then repairs the path on the
+        // background thread, even with a search budget, since D* Lite
+        // does not run in steps
+        inline void SetIncremental(bool incremental) { CancelRequests(); incremental_ = incremental; dstar_.Clear(); }
+        inline bool IsIncremental(void) const { return incremental_; }
+
+        // Change the cost of the edges between the nodes with indices a
+        // and b, in both directions, without compiling the graph again
+        // Jump Point Search and the Contraction Hierarchy no longer apply
+        // and are dropped until the next Compile() or BuildHierarchy().
+        // Throws std::invalid_argument if a node is not in the graph, the
+        // nodes are not connected, or the cost is negative
+        void SetEdgeCost(int a, int b, float cost);
+
+        // Keep the results of up to max_bytes of path queries, so that
+        // routes requested again are copied instead of searched. The
+        // least recently used routes are dropped first, and results of
+        // the graph before its last change are never returned. A budget
+        // of 0, the default, disables the cache
+        inline void SetPathCache(size_t max_bytes) { cache_.SetBudget(max_bytes); }
+        inline PathCacheStats GetPathCacheStats(void) const { return cache_.GetStats(); }
+        inline size_t GetPathCacheMemory(void) const { return cache_.GetMemory(); }
+
+        // Get a counter that increases whenever nodes are added or
+        // moved, the graph is compiled or cleared, or an edge cost changes
+        inline unsigned int GetVersion(void) const { return version_; }
+
+        // Get a counter that only increases when the layout of the graph
+        // changes: nodes are added or moved, or the graph is compiled or
+        // cleared. Edge costs do not change it
+        inline unsigned int GetLayoutVersion(void) const { return layout_version_; }
+
+        // Compute the shortest path between the nodes with indices
+        // start and end, and store the node indices on the path in
+        // order from start to end
+        //
+        // All search state is kept in the given context, so the graph
+        // is not modified and several searches can run concurrently as
+        // long as each one uses its own context. Compile() needs to be
+        // called before. If cost is given, it is set to the cost of the
+        // path. Returns false if there is no path
+        // The result comes from the path cache if it holds the route
+        bool FindPath(int start, int end, SearchContext &context, std::vector<int> &path, float *cost = NULL) const;
+
+        // Compute the next hop from every node towards the node with index
+        // goal, for units that all head to the same node. This costs one
+        // search, after which the path of each unit is read from the
+        // field. Compile() needs to be called before, and the field has
+        // to be built again once GetVersion() changes
+        void BuildFlowField(int goal, FlowField<CsrGraph> &field) const;
+
+        // Compute the costs from every source to every target with the
+        // workers of the given table, on the hierarchy if it was built
+        // The cost from sources[i] to targets[j] is stored in
+        // costs[i*num_targets + j], or INFINITY if there is no path, and
+        // the path in the entry of paths with the same index, if paths
+        // is not NULL. Compile() needs to be called before
+        void FindDistances(DistanceTable &table, const int *sources, int num_sources, const int *targets, int num_targets, std::vector<int> *paths, float *costs) const;
+
+        // Select the distance estimate used to guide the search
+        // HEURISTIC_ZERO runs Dijkstra's algorithm, the others run A*
+        // with the estimate scaled so that it stays admissible
+        // Either search uses Dial's bucket queue when all edge costs are
+        // small integers
+        void SetHeuristic(HeuristicType type);
+        inline HeuristicType GetHeuristic(void) const { return heuristic_type_; }
+
+        // Select whether the search grows from both the start and the end
+        // node at the same time, which roughly halves the explored area
+        // of long queries
+        inline void SetBidirectional(bool bidirectional) { CancelRequests(); bidirectional_ = bidirectional; }
+        inline bool IsBidirectional(void) const { return bidirectional_; }
+
+        // Get the statistics of the last query run by FindPath(void),
+        // which are zero if the path came from the path cache
+        inline const SearchStats &GetSearchStats(void) const { return stats_; }
+
+        // Check whether the node at the given index is on the current path
+        inline bool IsOnPath(int index) const { return (size_t) index < on_path_.size() && on_path_[index]; }
+
+        // Get the indices of the nodes for which IsOnPath() is true, and
+        // a counter that increases whenever they change
+        inline const std::vector<int> &GetMarkedNodes(void) const { return marked_node_; }
+        inline unsigned int GetPathVersion(void) const { return path_version_; }
  
         // Getters
         inline Node *GetStartNode(void) { return start_node_; }
@@ -67,17 +249,19 @@ class Graph {
         void BuildMaze(Graph& output);
 
     private:
-        // Sprite used to draw each node
-        GameObject *node_obj_;
-
-        // Sprite used to draw each edge
-        GameObject *edge_obj_;
-
         // Vector containing all the nodes in the graph
         std::vector<Node*> node_;
 
-        // Node that the mouse is hovering over
-        Node *hover_node_;
+        // Memory of the nodes, and of the edges added to them until the
+        // graph is compiled
+        Arena arena_;
+        Arena edge_arena_;
+
+        // Number of edges that new nodes have room for, set by Reserve()
+        int edge_capacity_;
+
+        // Positions of the nodes, for finding the nodes near a point
+        SpatialIndex spatial_index_;
 
         // Members for computing shortest paths in the graph
 
@@ -87,6 +271,106 @@ class Graph {
 
         // Nodes in current shortest path
         std::vector<Node*> path_node_;
+
+        // Flag for each node indicating whether it is on the current path
+        std::vector<unsigned char> on_path_;
+
+        // Indices of the nodes currently flagged in on_path_, and the
+        // number of times a path was marked
+        std::vector<int> marked_node_;
+        unsigned int path_version_;
+
+        // Start and end nodes of the marked path, or -1 if the graph
+        // changed since it was found
+        int path_start_, path_end_;
+
+        // Shortest-path tree of the start node, reused while only the
+        // end node changes
+        ShortestPathTree<CsrGraph> tree_;
+
+        // Start node of the last query run by FindPath(void), and the
+        // work done by that query
+        int last_query_start_;
+        SearchStats stats_;
+
+        // Search state used when finding the path for the display
+        SearchContext context_;
+
+        // Result of the search started by RequestPath(), if running
+        std::future<PathResult> pending_;
+
+        // Start and end nodes of the running and of the latest request,
+        // or -1. The latest request waits until the running one is done
+        int pending_start_, pending_end_;
+        int next_start_, next_end_;
+
+        // Search run in steps by UpdatePath(), and its budget per step
+        ResumableSearch<CsrGraph> stepped_;
+        int step_expansions_, step_microseconds_;
+
+        // Compact copy of the graph that the path search runs on
+        CsrGraph csr_;
+
+        // Flag indicating whether csr_ is up to date with node_
+        bool compiled_;
+
+        // Type of distance estimate selected for the search, and the
+        // estimate scaled for the compiled graph
+        HeuristicType heuristic_type_;
+        Heuristic heuristic_;
+
+        // Flag selecting bidirectional search
+        bool bidirectional_;
+
+        // Size of the grid if the graph was built with BuildGrid, or 0
+        int grid_cols_, grid_rows_;
+
+        // Jump Point Search, set up by Compile() when the graph is a grid
+        // with uniform costs
+        JumpPointSearch jps_;
+
+        // Contraction Hierarchy, built on request by BuildHierarchy()
+        ContractionHierarchy ch_;
+
+        // Flag selecting incremental searches, and their state
+        bool incremental_;
+        DStarLite dstar_;
+
+        // Version of the graph, and results of path queries on it
+        // Edges added to nodes only reach the searches through Compile(),
+        // which increases the version
+        unsigned int version_;
+        mutable PathCache cache_;
+
+        // Version of the nodes and edges, without their costs
+        unsigned int layout_version_;
+
+        // Background thread for RequestPath(), created on first use
+        // Declared last so that it finishes its search before the rest
+        // of the graph is destroyed
+        std::unique_ptr<AsyncSearch> async_;
+
+        // Search for a path without looking in the path cache
+        bool SearchPath(int start, int end, SearchContext &context, std::vector<int> &path, float &cost) const;
+
+        // Repair the D* Lite search for a path from start to end
+        // Returns false if there is no path
+        bool RepairPath(int start, int end, std::vector<int> &path, float &cost);
+
+        // Run a search for a path from start to end on the background
+        // thread, with D* Lite if the graph is incremental
+        void SubmitRequest(int start, int end);
+
+        // Check if there is an edge from node a to node b, in the nodes or
+        // in the compact graph
+        bool HasEdge(int a, int b);
+
+        // Flag the nodes on the given path, plus the start and end nodes
+        void MarkPath(int start, int end, const std::vector<int> &path);
+
+        // Wait for the search started by RequestPath() and drop requests
+        // that have not started, before the graph is changed
+        void CancelRequests(void);
 };
 
 } // namespace game
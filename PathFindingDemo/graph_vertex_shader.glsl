@@ -0,0 +1,39 @@
+// Source code of vertex shader for drawing many graph nodes or edges
+// in one call
+#version 130
+#extension GL_ARB_uniform_buffer_object : require
+
+// Vertex buffer
+in vec2 vertex;
+in vec3 color;
+in vec2 uv;
+
+// Instance buffer, advanced once per sprite
+in vec4 instance_transform; // Position (xy), rotation angle (z) and scale (w)
+in vec3 instance_color; // Color modifier
+
+// Per-frame constants, shared by all shaders
+layout(std140) uniform FrameData {
+    mat4 view_matrix;
+    float time;
+};
+
+// Attributes forwarded to the fragment shader
+out vec4 color_interp;
+out vec2 uv_interp;
+out vec3 color_mod_interp;
+
+void main()
+{
+    // Scale, rotate and translate the vertex, like the transformation
+    // matrix of a single sprite
+    float c = cos(instance_transform.z);
+    float s = sin(instance_transform.z);
+    vec2 pos = mat2(c, s, -s, c)*(vertex*instance_transform.w) + instance_transform.xy;
+    gl_Position = view_matrix*vec4(pos, 0.0, 1.0);
+
+    // Pass attributes to fragment shader
+    color_interp = vec4(color, 1.0);
+    uv_interp = uv;
+    color_mod_interp = instance_color;
+}
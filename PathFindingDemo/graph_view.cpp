@@ -0,0 +1,469 @@
+#include <glm/gtc/matrix_transform.hpp> 
+#include <algorithm>
+
+#include "gl_state.h"
+#include "graph_view.h"
+
+namespace game {
+
+// Largest number of unchanged colors uploaded to join two ranges of
+// changed colors into one upload
+const int color_merge_gap_g = 16;
+
+
+GraphView::GraphView(void){
+
+    // Initialize all members to default values
+    graph_ = NULL;
+    node_obj_ = NULL;
+    edge_obj_ = NULL;
+    hover_node_ = NULL;
+    instanced_shader_ = NULL;
+    transform_vbo_ = 0;
+    color_vbo_ = 0;
+    node_vao_ = 0;
+    edge_vao_ = 0;
+    built_version_ = 0;
+    built_nodes_ = -1;
+    shown_path_version_ = 0;
+    shown_start_ = NULL;
+    shown_end_ = NULL;
+    shown_hover_ = NULL;
+}
+
+
+void GraphView::Attach(Graph *graph, GameObject *node_sprite, GameObject *edge_sprite, Shader *instanced_shader){
+
+    // Set the graph and the sprite game objects
+    graph_ = graph;
+    node_obj_ = node_sprite;
+    edge_obj_ = edge_sprite;
+    hover_node_ = NULL;
+    instanced_shader_ = instanced_shader;
+
+    // Build the instance buffers of the new graph at the next frame
+    built_nodes_ = -1;
+}
+
+
+void GraphView::Update(GLFWwindow *window, float zoom){
+
+    // Show the path of the last finished search
+    graph_->UpdatePath();
+
+    // Get mouse pixel position in the window
+    double xpos, ypos;
+    glfwGetCursorPos(window, &xpos, &ypos);
+
+    // Get information about the window
+    int width, height;
+    glfwGetWindowSize(window, &width, &height);
+
+    // Find node at the given pixel position
+    Node *n = SelectNode(xpos, ypos, width, height, zoom);
+
+    // Set the hover node to this node
+    // It is fine if the node is NULL
+    hover_node_ = n;
+
+    // Check mouse clicks
+    if (glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS){
+        
+        // Set the start to selected node, if node exists and is not the end-node
+        if (n != NULL && n != graph_->GetEndNode()) {
+            graph_->SetStartNode(n);
+        }
+
+        // Search for a path between currently selected nodes in the
+        // background, so that the frame does not wait for it
+        graph_->RequestPath();
+    }
+
+    if (glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_RIGHT) == GLFW_PRESS) {
+
+        // Set the end to selected node, if node exists and is not the start-node
+        if (n != NULL && n != graph_->GetStartNode()) {
+            graph_->SetEndNode(n);
+        }
+
+        // Search for a path between currently selected nodes in the
+        // background, so that the frame does not wait for it
+        graph_->RequestPath();
+    }
+}
+
+
+Node *GraphView::SelectNode(double x, double y, int window_width, int window_height, float camera_zoom){
+
+    // If the mouse is outside the window, return NULL
+    if (x < 0 || x > window_width || y < 0 || y > window_height) {
+        return NULL;
+    }
+
+    // Get position in world coordinates corresponding to the mouse
+    // pixel position on the window
+    float w = window_width;
+    float h = window_height;
+    float cursor_x_pos = 0.0;
+    float cursor_y_pos = 0.0;
+    if (w > h){
+        float aspect_ratio = w/h;
+        cursor_x_pos = ((2.0f*x - w)*aspect_ratio)/(w*camera_zoom);
+        cursor_y_pos = (-2.0f*y + h)/(h*camera_zoom);
+    } else {
+        float aspect_ratio = h/w;
+        cursor_x_pos = (2.0f*x - w)/(w*camera_zoom);
+        cursor_y_pos = ((-2.0f*y + h)*aspect_ratio)/(h*camera_zoom);
+    }
+
+    // Find the node at the derived position, i.e. the closest one with
+    // the mouse inside its ball of radius scale*scale
+    // The spatial index of the graph only checks the nearby nodes
+    float node_scale = node_obj_->GetScale();
+    int index = graph_->FindNearestNode(cursor_x_pos, cursor_y_pos, node_scale*node_scale);
+
+    // Return NULL if no node was found
+    return index == -1 ? NULL : graph_->GetNode(index);
+}
+
+
+void GraphView::Render(glm::mat4 view_matrix, double current_time){
+
+    if (instanced_shader_ != NULL) {
+        RenderInstanced();
+    } else {
+        RenderObjects(view_matrix, current_time);
+    }
+}
+
+
+glm::vec3 GraphView::GetNodeColor(int index) const {
+
+    // Change the color depending on whether the node is the start or
+    // end node of the path, a node in the middle of the path, or the
+    // mouse is hovering over the node
+    Node *node = graph_->GetNode(index);
+    if (node == graph_->GetStartNode()) {
+        return glm::vec3(1.0f, 0.0f, 0.0f); // Red
+    } else if (node == graph_->GetEndNode()) {
+        return glm::vec3(0.0f, 0.0f, 1.0f); // Blue
+    } else if (node == hover_node_) {
+        return glm::vec3(1.0f, 0.6f, 1.0f); // Pink
+    } else if (graph_->IsOnPath(index)) {
+        return glm::vec3(0.0f, 1.0f, 0.0f); // Light green
+    }
+
+    // The default color is green
+    return glm::vec3(0.0f, 0.6f, 0.0f); // Dark green
+}
+
+
+glm::vec3 GraphView::GetEdgeColor(Node *n1, Node *n2) const {
+
+    // Change the color depending on whether the edge is on the path
+    if (graph_->IsOnPath(n1->GetId()) && graph_->IsOnPath(n2->GetId())) {
+        return glm::vec3(0.0f, 1.0f, 0.0f); // Lighter green
+    }
+    return glm::vec3(0.0f, 0.6f, 0.0f); // Dark green
+}
+
+
+bool GraphView::IsVertical(Node *n1, Node *n2){
+
+    return (n2->GetY() > n1->GetY()) || (n2->GetY() < n1->GetY());
+}
+
+
+void GraphView::RenderObjects(glm::mat4 view_matrix, double current_time){
+
+    // First, render all the nodes in the graph so that they appear on
+    // top of the edges
+    //
+    // Go through each node and render it using the provided game object
+    // Like the instanced path, only the graph of the last compile is
+    // drawn: nodes and edges added since show up once the next search
+    // compiles the graph
+    const CsrGraph &csr = graph_->GetLastCompiledGraph();
+    for (int i = 0; i < csr.GetNumNodes(); i++) {
+        
+        // Get the current node to draw
+        Node *current_node = graph_->GetNode(i);
+
+        // Set the position of the sprite with the position of the node
+        glm::vec3 pos(current_node->GetX(), current_node->GetY(), 0.0f);
+        node_obj_->SetPosition(pos);
+        
+        // Set the color of the node via the color modifier uniform
+        node_obj_->SetColorModifier(GetNodeColor(i));
+        
+        // Render the game object for the current node
+        node_obj_->Render(view_matrix, current_time);
+    }
+
+    // Now, render all the edges in the graph, which are kept in its
+    // compact representation
+    for (int i = 0; i < csr.GetNumNodes(); i++) {
+        
+        // Get the current node to draw
+        Node *current_node = graph_->GetNode(i);
+
+        // Render the edges of this node
+        for (uint32_t e = csr.EdgeBegin(i); e < csr.EdgeEnd(i); e++) {
+            // Get pointer to neighbor
+            Node *neigh = graph_->GetNode(csr.GetTarget(e));
+
+            // Each edge is stored in both of its nodes, so only draw it
+            // from the node with the lower id
+            if (neigh->GetId() < current_node->GetId()) {
+                continue;
+            }
+
+            // Set the position of the edge sprite between the current
+            // node and its neighbor
+            glm::vec3 pos((current_node->GetX() + neigh->GetX())/2.0, 
+                          (current_node->GetY() + neigh->GetY())/2.0, 0.0f);
+            edge_obj_->SetPosition(pos);
+
+            // Check if the edge needs to be rotated
+            if (IsVertical(current_node, neigh)){
+                edge_obj_->SetRotation(glm::pi<float>()/2.0);
+            } else {
+                edge_obj_->SetRotation(0.0);
+            }
+
+            // Set the color of the edge via the color modifier uniform
+            edge_obj_->SetColorModifier(GetEdgeColor(current_node, neigh));
+
+            // Render the game object for the current edge
+            edge_obj_->Render(view_matrix, current_time);
+        }
+    }
+}
+
+
+void GraphView::RenderInstanced(void){
+
+    // The placement of the sprites only changes with the layout of the
+    // graph, so the buffers are only filled again when nodes or edges
+    // were added or moved, and not when edge costs change. Otherwise
+    // only the colors that changed are uploaded. While nodes or edges
+    // are being added the graph is not compiled, and the last buffers
+    // are kept until it is, unless nodes were removed by a clear
+    bool changed = built_nodes_ != graph_->GetNumNodes() || built_version_ != graph_->GetLayoutVersion();
+    if (changed && (graph_->IsCompiled() || built_nodes_ < 0 || built_nodes_ > graph_->GetNumNodes())) {
+        BuildInstances();
+    } else {
+        UpdateColors();
+    }
+
+    // Set up the shader once for both calls
+    // The view matrix is read from the frame uniforms
+    instanced_shader_->Enable();
+
+    // Render the nodes first so that they appear on top of the edges
+    DrawInstances(node_vao_, node_obj_, built_nodes_);
+    DrawInstances(edge_vao_, edge_obj_, color_.size() - built_nodes_);
+}
+
+
+void GraphView::BuildInstances(void){
+
+    // Gather one instance per node, followed by one instance per edge
+    // Each edge is stored in both of its nodes, so it is only taken
+    // from the node with the lower id
+    const CsrGraph &csr = graph_->GetLastCompiledGraph();
+    int num_nodes = graph_->GetNumNodes();
+    std::vector<InstanceTransform> transform;
+    color_.clear();
+    edge_node_.clear();
+    for (int i = 0; i < num_nodes; i++) {
+        Node *node = graph_->GetNode(i);
+        InstanceTransform instance = {node->GetX(), node->GetY(), 0.0f, node_obj_->GetScale()};
+        transform.push_back(instance);
+        color_.push_back(ToColor(GetNodeColor(i)));
+    }
+    incident_offset_.assign(num_nodes + 1, 0);
+    for (int i = 0; i < csr.GetNumNodes(); i++) {
+        Node *node = graph_->GetNode(i);
+        for (uint32_t e = csr.EdgeBegin(i); e < csr.EdgeEnd(i); e++) {
+            Node *neigh = graph_->GetNode(csr.GetTarget(e));
+            if (neigh->GetId() < node->GetId()) {
+                continue;
+            }
+            float angle = IsVertical(node, neigh) ? glm::pi<float>()/2.0f : 0.0f;
+            InstanceTransform instance = {(node->GetX() + neigh->GetX())/2.0f, (node->GetY() + neigh->GetY())/2.0f, angle, edge_obj_->GetScale()};
+            transform.push_back(instance);
+            color_.push_back(ToColor(GetEdgeColor(node, neigh)));
+            edge_node_.push_back(node->GetId());
+            edge_node_.push_back(neigh->GetId());
+            incident_offset_[node->GetId() + 1]++;
+            incident_offset_[neigh->GetId() + 1]++;
+        }
+    }
+
+    // List the edge instances of each node, so that the edges of a node
+    // can be found when its color changes
+    for (int i = 0; i < num_nodes; i++) {
+        incident_offset_[i+1] += incident_offset_[i];
+    }
+    incident_.resize(incident_offset_[num_nodes]);
+    std::vector<int> next(incident_offset_.begin(), incident_offset_.end() - 1);
+    for (int e = 0; e < edge_node_.size()/2; e++) {
+        incident_[next[edge_node_[2*e]]++] = num_nodes + e;
+        incident_[next[edge_node_[2*e+1]]++] = num_nodes + e;
+    }
+
+    // Upload the placement once, and the colors for later updates
+    if (transform_vbo_ == 0) {
+        glGenBuffers(1, &transform_vbo_);
+        glGenBuffers(1, &color_vbo_);
+        glGenVertexArrays(1, &node_vao_);
+        glGenVertexArrays(1, &edge_vao_);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, transform_vbo_);
+    glBufferData(GL_ARRAY_BUFFER, transform.size()*sizeof(InstanceTransform), transform.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, color_vbo_);
+    glBufferData(GL_ARRAY_BUFFER, color_.size()*sizeof(InstanceColor), color_.data(), GL_DYNAMIC_DRAW);
+    SetInstanceLayout(node_vao_, node_obj_, 0);
+    SetInstanceLayout(edge_vao_, edge_obj_, num_nodes);
+    dirty_.clear();
+    built_nodes_ = num_nodes;
+    built_version_ = graph_->GetLayoutVersion();
+    SaveHighlight();
+}
+
+
+void GraphView::UpdateColors(void){
+
+    // Nothing to do if the path and the highlighted nodes are the same
+    if (shown_path_version_ == graph_->GetPathVersion() && shown_start_ == graph_->GetStartNode() &&
+        shown_end_ == graph_->GetEndNode() && shown_hover_ == hover_node_) {
+        return;
+    }
+
+    // Only the nodes highlighted in the last frame or in this one can
+    // have a new color, so the cost depends on the size of the path
+    // instead of the size of the graph
+    check_ = highlight_;
+    SaveHighlight();
+    check_.insert(check_.end(), highlight_.begin(), highlight_.end());
+    for (int i = 0; i < check_.size(); i++) {
+        RefreshColor(check_[i]);
+    }
+    if (dirty_.empty()) {
+        return;
+    }
+
+    // Upload the changed colors in ranges, joining ranges separated by
+    // a few unchanged colors to save calls
+    std::sort(dirty_.begin(), dirty_.end());
+    glBindBuffer(GL_ARRAY_BUFFER, color_vbo_);
+    int first = 0;
+    for (int i = 1; i <= dirty_.size(); i++) {
+        if (i == dirty_.size() || dirty_[i] - dirty_[i-1] > color_merge_gap_g) {
+            int begin = dirty_[first];
+            int end = dirty_[i-1] + 1;
+            glBufferSubData(GL_ARRAY_BUFFER, begin*sizeof(InstanceColor), (end - begin)*sizeof(InstanceColor), &color_[begin]);
+            first = i;
+        }
+    }
+    dirty_.clear();
+}
+
+
+void GraphView::RefreshColor(int index){
+
+    // Nodes added since the buffers were built are not drawn yet
+    if (index >= built_nodes_) {
+        return;
+    }
+
+    // Color of the node
+    InstanceColor color = ToColor(GetNodeColor(index));
+    InstanceColor &old_color = color_[index];
+    if (color.r != old_color.r || color.g != old_color.g || color.b != old_color.b) {
+        old_color = color;
+        dirty_.push_back(index);
+    }
+
+    // Colors of its edges, which depend on both of their nodes
+    for (int k = incident_offset_[index]; k < incident_offset_[index+1]; k++) {
+        int e = incident_[k];
+        int edge = e - built_nodes_;
+        color = ToColor(GetEdgeColor(graph_->GetNode(edge_node_[2*edge]), graph_->GetNode(edge_node_[2*edge+1])));
+        InstanceColor &old_edge_color = color_[e];
+        if (color.r != old_edge_color.r || color.g != old_edge_color.g || color.b != old_edge_color.b) {
+            old_edge_color = color;
+            dirty_.push_back(e);
+        }
+    }
+}
+
+
+void GraphView::SaveHighlight(void){
+
+    // The nodes on the path include the start and end nodes of the path,
+    // but the selected start and end nodes may differ while a search
+    // runs
+    const std::vector<int> &marked = graph_->GetMarkedNodes();
+    highlight_.assign(marked.begin(), marked.end());
+    if (graph_->GetStartNode() != NULL) {
+        highlight_.push_back(graph_->GetStartNode()->GetId());
+    }
+    if (graph_->GetEndNode() != NULL) {
+        highlight_.push_back(graph_->GetEndNode()->GetId());
+    }
+    if (hover_node_ != NULL) {
+        highlight_.push_back(hover_node_->GetId());
+    }
+    shown_path_version_ = graph_->GetPathVersion();
+    shown_start_ = graph_->GetStartNode();
+    shown_end_ = graph_->GetEndNode();
+    shown_hover_ = hover_node_;
+}
+
+
+void GraphView::SetInstanceLayout(GLuint vao, GameObject *sprite, int first){
+
+    // Set up the vertices of the sprite
+    GLState::BindVertexArray(vao);
+    sprite->GetGeometry()->SetLayout(instanced_shader_);
+
+    // Read the instance attributes from the instance buffers, advancing
+    // once per sprite instead of once per vertex
+    glBindBuffer(GL_ARRAY_BUFFER, transform_vbo_);
+    GLint transform_att = instanced_shader_->GetAttribLocation("instance_transform");
+    glVertexAttribPointer(transform_att, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceTransform), (void *)(first*sizeof(InstanceTransform)));
+    glEnableVertexAttribArray(transform_att);
+    glVertexAttribDivisor(transform_att, 1);
+
+    glBindBuffer(GL_ARRAY_BUFFER, color_vbo_);
+    GLint color_att = instanced_shader_->GetAttribLocation("instance_color");
+    glVertexAttribPointer(color_att, 3, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(InstanceColor), (void *)(first*sizeof(InstanceColor)));
+    glEnableVertexAttribArray(color_att);
+    glVertexAttribDivisor(color_att, 1);
+}
+
+
+void GraphView::DrawInstances(GLuint vao, GameObject *sprite, int count){
+
+    if (count == 0) {
+        return;
+    }
+
+    // Draw all the sprites with the texture of the game object
+    Geometry *geometry = sprite->GetGeometry();
+    geometry->SetState();
+    GLState::BindVertexArray(vao);
+    GLState::BindTexture(sprite->GetTexture());
+    glDrawElementsInstanced(GL_TRIANGLES, geometry->GetSize(), GL_UNSIGNED_INT, 0, count);
+}
+
+
+GraphView::InstanceColor GraphView::ToColor(const glm::vec3 &color){
+
+    InstanceColor c = {(GLubyte) (color.r*255.0f + 0.5f), (GLubyte) (color.g*255.0f + 0.5f), (GLubyte) (color.b*255.0f + 0.5f), 255};
+    return c;
+}
+
+} // namespace game
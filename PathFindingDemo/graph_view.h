@@ -0,0 +1,151 @@
+#ifndef GRAPH_VIEW_H_
+#define GRAPH_VIEW_H_
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "graph.h"
+#include "shader.h"
+#include "game_object.h"
+
+namespace game {
+
+// Displays a graph in the demo and lets the user pick the start and end
+// nodes of the path with the mouse
+//
+// All OpenGL and window code of the graph lives here, so that Graph
+// itself can be used without a display
+class GraphView {
+
+    public:
+        // Create a view that is not attached to any graph
+        GraphView(void);
+
+        // Display the given graph with the given sprites
+        // If a shader for instanced sprites is given, all the nodes are
+        // drawn in one call, and all the edges in another. Otherwise,
+        // each node and edge is drawn as a separate game object
+        void Attach(Graph *graph, GameObject *node_sprite, GameObject *edge_sprite, Shader *instanced_shader = NULL);
+
+        // Get mouse input, update start and end node, and request the
+        // shortest path between the two nodes
+        void Update(GLFWwindow *window, float zoom);
+
+        // Return the node at the (x, y) coordinate of the window
+        Node *SelectNode(double x, double y, int window_width, int window_height, float camera_zoom);
+
+        // Render all the nodes in the graph
+        // The instanced shader reads the view matrix from the frame
+        // uniforms instead
+        void Render(glm::mat4 view_matrix, double current_time);
+
+    private:
+        // Placement of one sprite drawn by an instanced call, matching
+        // the instance attributes of the shader
+        struct InstanceTransform {
+            GLfloat x, y; // Position
+            GLfloat angle; // Rotation angle
+            GLfloat scale; // Scale
+        };
+
+        // Color modifier of one sprite, normalized to bytes
+        struct InstanceColor {
+            GLubyte r, g, b, a;
+        };
+
+        // Graph being displayed
+        Graph *graph_;
+
+        // Sprite used to draw each node
+        GameObject *node_obj_;
+
+        // Sprite used to draw each edge
+        GameObject *edge_obj_;
+
+        // Node that the mouse is hovering over
+        Node *hover_node_;
+
+        // Shader for instanced sprites, or NULL
+        Shader *instanced_shader_;
+
+        // Buffers with the placement and the color of all nodes followed
+        // by all edges. The placement is only uploaded when the graph
+        // changes, and the colors when they change
+        GLuint transform_vbo_;
+        GLuint color_vbo_;
+
+        // Vertex arrays reading the sprite and the node or edge range of
+        // the instance buffers, recorded when the buffers are built
+        GLuint node_vao_;
+        GLuint edge_vao_;
+
+        // Layout version and number of nodes of the graph in the buffers,
+        // or -1 if the buffers are not built
+        unsigned int built_version_;
+        int built_nodes_;
+
+        // Colors in the color buffer, and the indices of those changed
+        // since it was uploaded
+        std::vector<InstanceColor> color_;
+        std::vector<int> dirty_;
+
+        // Nodes of each edge instance, and the edge instances of each
+        // node: those of node i are incident_[incident_offset_[i]] up
+        // to incident_[incident_offset_[i+1]]
+        std::vector<int> edge_node_;
+        std::vector<int> incident_offset_;
+        std::vector<int> incident_;
+
+        // Nodes drawn with another color than the default in the last
+        // frame, and the state of the graph they were drawn for
+        std::vector<int> highlight_;
+        std::vector<int> check_;
+        unsigned int shown_path_version_;
+        Node *shown_start_;
+        Node *shown_end_;
+        Node *shown_hover_;
+
+        // Get the color modifier of the node at the given index, and of
+        // the edge between two nodes
+        glm::vec3 GetNodeColor(int index) const;
+        glm::vec3 GetEdgeColor(Node *n1, Node *n2) const;
+
+        // Check whether the edge between two nodes needs to be rotated
+        static bool IsVertical(Node *n1, Node *n2);
+
+        // Draw each node and edge as a separate game object
+        void RenderObjects(glm::mat4 view_matrix, double current_time);
+
+        // Draw all nodes and all edges with one instanced call each
+        void RenderInstanced(void);
+
+        // Fill both instance buffers from the graph
+        void BuildInstances(void);
+
+        // Update the colors of the nodes whose state changed since the
+        // last frame, and of their edges, and upload them
+        void UpdateColors(void);
+
+        // Recompute the color of a node and of its edges, and flag those
+        // that changed
+        void RefreshColor(int index);
+
+        // Remember the nodes that are highlighted in this frame
+        void SaveHighlight(void);
+
+        // Record in a vertex array the sprite of a game object and the
+        // instances starting at first
+        void SetInstanceLayout(GLuint vao, GameObject *sprite, int first);
+
+        // Draw count sprites of a game object with a vertex array
+        void DrawInstances(GLuint vao, GameObject *sprite, int count);
+
+        // Convert a color modifier to bytes
+        static InstanceColor ToColor(const glm::vec3 &color);
+};
+
+} // namespace game
+
+#endif // GRAPH_VIEW_H_
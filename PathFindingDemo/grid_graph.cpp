@@ -0,0 +1,103 @@
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#include "grid_graph.h"
+#include "heuristic.h"
+#include "astar.h"
+
+namespace game {
+
+GridGraph::GridGraph(void){
+
+    Clear();
+}
+
+
+void GridGraph::Build(int cols, int rows, float disp_x, float disp_y, float start_x, float start_y){
+
+    Clear();
+    cols_ = cols;
+    rows_ = rows;
+    disp_x_ = disp_x;
+    disp_y_ = disp_y;
+    start_x_ = start_x;
+    start_y_ = start_y;
+
+    // Start without edges
+    right_.assign(cols*rows, 0);
+    down_.assign(cols*rows, 0);
+
+    // Right, down, left, up
+    step_[0] = 1;
+    step_[1] = cols;
+    step_[2] = -1;
+    step_[3] = -cols;
+}
+
+
+void GridGraph::Connect(int n1, int n2, int cost){
+
+    if (cost < 1 || cost > 255){
+        throw(std::runtime_error(std::string("Grid edge costs must be between 1 and 255")));
+    }
+
+    // Store the edge with the cell on the left or at the top
+    int a = std::min(n1, n2);
+    int b = std::max(n1, n2);
+    if (a < 0 || b >= GetNumNodes()){
+        throw(std::runtime_error(std::string("Grid cell out of range")));
+    }
+    if (b == a + 1 && b % cols_ != 0){
+        right_[a] = cost;
+    } else if (b == a + cols_){
+        down_[a] = cost;
+    } else {
+        throw(std::runtime_error(std::string("Grid cells are not neighbors")));
+    }
+
+    min_cost_ = std::min(min_cost_, (float) cost);
+    max_cost_ = std::max(max_cost_, (float) cost);
+}
+
+
+void GridGraph::Clear(void){
+
+    cols_ = 0;
+    rows_ = 0;
+    disp_x_ = 0.0f;
+    disp_y_ = 0.0f;
+    start_x_ = 0.0f;
+    start_y_ = 0.0f;
+    std::vector<unsigned char>().swap(right_);
+    std::vector<unsigned char>().swap(down_);
+    std::fill(step_, step_ + 4, 0);
+    min_cost_ = INFINITY;
+    max_cost_ = 0.0f;
+}
+
+
+bool GridGraph::FindPath(int start, int end, SearchContext &context, std::vector<int> &path, float *cost) const {
+
+    // Every move changes the position by one cell along x or y, so the
+    // lowest edge cost per cell size bounds the cost per unit of
+    // Manhattan distance. This avoids scanning all edges to scale the
+    // estimate, as Heuristic::ForGraph does
+    path.clear();
+    float cell = std::max(std::fabs(disp_x_), std::fabs(disp_y_));
+    Heuristic heuristic;
+    if (max_cost_ > 0.0f && cell > 0.0f){
+        heuristic = Heuristic(HEURISTIC_MANHATTAN, min_cost_ / cell * 0.9999f);
+    }
+
+    if (!AStar(*this, start, end, heuristic, context.GetHeap(), context)){
+        return false;
+    }
+    context.GetPath(end, path);
+    if (cost != NULL){
+        *cost = context.GetCost(end);
+    }
+    return true;
+}
+
+} // namespace game
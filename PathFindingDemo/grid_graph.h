@@ -0,0 +1,117 @@
+#ifndef GRID_GRAPH_H_
+#define GRID_GRAPH_H_
+
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+
+#include "search_context.h"
+
+namespace game {
+
+// A 4-connected grid graph that stores no nodes or edge lists
+//
+// Cell (i, j), in row i and column j, corresponds to node i*cols + j,
+// and its neighbors and position are computed from the index. The only
+// storage is the cost of the edge to the right and to the bottom of
+// each cell, one byte each, where 0 means that there is no edge. A
+// 4096x4096 grid then takes 32 MB instead of the gigabytes used by the
+// nodes and edges of a Graph
+//
+// The graph provides the same interface as a CsrGraph, so the search
+// templates (Dijkstra, AStar, BidirectionalSearch) run on it directly.
+// Every node has four edges, one per direction: edge 4n + d leaves node
+// n in direction d (right, down, left, up). Missing edges are loops
+// with infinite cost, which a search never relaxes
+//
+// It is a standalone type that Graph does not use: the demo keeps its
+// grid of nodes, and programs with grids too large for a Graph build a
+// GridGraph instead
+class GridGraph {
+
+    public:
+        // Create an empty grid
+        GridGraph(void);
+
+        // Set up a grid with cols x rows cells and no edges
+        // Cell (0, 0) is at position (start_x, start_y), columns go
+        // right by disp_x and rows go down by disp_y, as in
+        // Graph::BuildGrid
+        void Build(int cols, int rows, float disp_x, float disp_y, float start_x, float start_y);
+
+        // Connect two neighboring cells with an edge in both directions
+        // The cost has to be an integer from 1 to 255
+        void Connect(int n1, int n2, int cost);
+
+        // Release the memory used by the grid
+        void Clear(void);
+
+        // Get size information
+        inline int GetNumCols(void) const { return cols_; }
+        inline int GetNumRows(void) const { return rows_; }
+        inline int GetNumNodes(void) const { return cols_*rows_; }
+
+        // Get the position of node n
+        inline float GetX(int n) const { return start_x_ + (n % cols_)*disp_x_; }
+        inline float GetY(int n) const { return start_y_ - (n / cols_)*disp_y_; }
+
+        // Get the range of edges leaving node n
+        inline uint32_t EdgeBegin(int n) const { return 4*(uint32_t) n; }
+        inline uint32_t EdgeEnd(int n) const { return 4*(uint32_t) n + 4; }
+
+        // Get the target node index and the cost of edge e
+        inline int GetTarget(uint32_t e) const { return Weight(e) ? (int) (e >> 2) + step_[e & 3] : (int) (e >> 2); }
+        inline float GetCost(uint32_t e) const { int w = Weight(e); return w ? (float) w : INFINITY; }
+
+        // Get the range of the edge costs
+        inline float GetMinCost(void) const { return min_cost_; }
+        inline float GetMaxCost(void) const { return max_cost_; }
+
+        // Check if every edge cost is no larger than max_cost
+        // All costs are integers, so integer priority queues can be used
+        inline bool HasIntegerCosts(int max_cost) const { return max_cost_ <= max_cost; }
+
+        // Compute the shortest path between nodes start and end with A*,
+        // and store the node indices on the path in order from start to
+        // end. If cost is given, it is set to the cost of the path.
+        // Returns false if there is no path
+        bool FindPath(int start, int end, SearchContext &context, std::vector<int> &path, float *cost = NULL) const;
+
+    private:
+        // Size of the grid
+        int cols_, rows_;
+
+        // Layout of the cells
+        float disp_x_, disp_y_;
+        float start_x_, start_y_;
+
+        // Cost of the edge from each cell to the cell on its right and
+        // to the cell below it, or 0 if there is no edge
+        std::vector<unsigned char> right_;
+        std::vector<unsigned char> down_;
+
+        // Index offset of the neighbor in each direction
+        int step_[4];
+
+        // Range of the edge costs
+        float min_cost_, max_cost_;
+
+        // Get the cost of edge e as stored, or 0 if there is no edge
+        // The edge to the left of a cell is the edge to the right of the
+        // previous cell, which is 0 on the first column since the last
+        // column has no edge to the right
+        inline int Weight(uint32_t e) const {
+            uint32_t n = e >> 2;
+            switch (e & 3){
+                case 0: return right_[n];
+                case 1: return down_[n];
+                case 2: return n > 0 ? right_[n-1] : 0;
+                default: return n >= (uint32_t) cols_ ? down_[n-cols_] : 0;
+            }
+        }
+};
+
+} // namespace game
+
+#endif // GRID_GRAPH_H_
@@ -0,0 +1,114 @@
+#ifndef HEURISTIC_H_
+#define HEURISTIC_H_
+
+#include <cmath>
+#include <algorithm>
+#include <cstdint>
+
+namespace game {
+
+// Distance estimates available for A* search
+enum HeuristicType {
+    HEURISTIC_ZERO, // No estimate, A* behaves like Dijkstra's algorithm
+    HEURISTIC_EUCLIDEAN, // Straight-line distance
+    HEURISTIC_MANHATTAN, // Sum of the distances along x and y
+    HEURISTIC_OCTILE // Distance with horizontal, vertical and diagonal moves
+};
+
+
+// Estimate of the cost between two nodes based on their positions
+//
+// The estimate is a distance between the positions multiplied by a
+// scale, which is the minimum cost per unit of that distance over all
+// the edges of the graph. Since each of the distances satisfies the
+// triangle inequality, the cost of any path is at least the scale times
+// the distance between its endpoints, so the estimate never exceeds the
+// real cost (it is admissible) and never drops by more than the cost of
+// an edge along it (it is consistent)
+//
+// On graphs with integer costs, the estimate can be rounded down to an
+// integer. It stays admissible and consistent, and all the keys of A*
+// become integers, so the search can use a bucket queue
+class Heuristic {
+
+    public:
+        // Create a heuristic of the given type with the given scale
+        Heuristic(HeuristicType type = HEURISTIC_ZERO, float scale = 0.0f) {
+            type_ = type;
+            scale_ = scale;
+            integer_ = false;
+        }
+
+        // Create a heuristic of the given type that is admissible for
+        // the given graph
+        // The graph needs to provide the compact-graph interface and
+        // node positions (GetX, GetY)
+        template <typename GraphType>
+        static Heuristic ForGraph(const GraphType &graph, HeuristicType type){
+
+            // Find the minimum cost per unit distance over all edges
+            // Edges between nodes at the same position give no bound
+            float scale = INFINITY;
+            for (int n = 0; n < graph.GetNumNodes(); n++){
+                uint32_t edge_end = graph.EdgeEnd(n);
+                for (uint32_t e = graph.EdgeBegin(n); e < edge_end; e++){
+                    int m = graph.GetTarget(e);
+                    float d = Distance(type, graph.GetX(m) - graph.GetX(n), graph.GetY(m) - graph.GetY(n));
+                    if (d > 0.0f){
+                        scale = std::min(scale, graph.GetCost(e) / d);
+                    }
+                }
+            }
+            if (type == HEURISTIC_ZERO || scale == INFINITY){
+                return Heuristic(HEURISTIC_ZERO, 0.0f);
+            }
+
+            // Shrink the scale slightly so that floating-point rounding
+            // cannot make the estimate exceed the real cost
+            return Heuristic(type, scale * 0.9999f);
+        }
+
+        // Getters
+        inline HeuristicType GetType(void) const { return type_; }
+        inline float GetScale(void) const { return scale_; }
+
+        // Get a copy of the heuristic whose estimates are rounded down to
+        // integers, for graphs where all edge costs are integers
+        inline Heuristic Floored(void) const { Heuristic h = *this; h.integer_ = true; return h; }
+
+        // Estimate the cost from (x1, y1) to (x2, y2)
+        inline float Estimate(float x1, float y1, float x2, float y2) const {
+            float estimate = scale_ * Distance(type_, x2 - x1, y2 - y1);
+            return integer_ ? std::floor(estimate) : estimate;
+        }
+
+        // Compute the distance of the given type for displacement (dx, dy)
+        static inline float Distance(HeuristicType type, float dx, float dy){
+            dx = std::fabs(dx);
+            dy = std::fabs(dy);
+            switch (type){
+                case HEURISTIC_EUCLIDEAN:
+                    return std::sqrt(dx*dx + dy*dy);
+                case HEURISTIC_MANHATTAN:
+                    return dx + dy;
+                case HEURISTIC_OCTILE:
+                    return std::max(dx, dy) + (std::sqrt(2.0f) - 1.0f)*std::min(dx, dy);
+                default:
+                    return 0.0f;
+            }
+        }
+
+    private:
+        // Type of distance
+        HeuristicType type_;
+
+        // Minimum cost per unit distance
+        float scale_;
+
+        // Flag indicating that estimates are rounded down to integers
+        bool integer_;
+};
+
+} // namespace game
+
+#endif // HEURISTIC_H_
@@ -0,0 +1,443 @@
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+
+#include "jump_point_search.h"
+
+namespace game {
+
+// Directions of the moves on the grid
+// The first four are straight moves, the last four diagonal moves
+const int num_directions_g = 8;
+const int direction_x_g[num_directions_g] = {1, -1, 0, 0, 1, 1, -1, -1};
+const int direction_y_g[num_directions_g] = {0, 0, 1, -1, 1, -1, 1, -1};
+
+// Get the index of direction (dx, dy) in the arrays above
+static int DirectionIndex(int dx, int dy){
+
+    for (int d = 0; d < num_directions_g; d++){
+        if (direction_x_g[d] == dx && direction_y_g[d] == dy){
+            return d;
+        }
+    }
+    return -1;
+}
+
+
+// Get the sign of an integer
+static inline int Sign(int v){
+
+    return (v > 0) - (v < 0);
+}
+
+
+JumpPointSearch::JumpPointSearch(void){
+
+    Clear();
+}
+
+
+void JumpPointSearch::Build(int cols, int rows, const std::vector<unsigned char> &passable, bool diagonal, float cost, bool precompute){
+
+    // Store the description of the grid
+    cols_ = cols;
+    rows_ = rows;
+    passable_ = passable;
+    diagonal_ = diagonal;
+    cost_ = cost;
+    diagonal_cost_ = cost*std::sqrt(2.0f);
+
+    // Fill the jump table for JPS+
+    jump_.clear();
+    if (precompute){
+        Precompute();
+    }
+}
+
+
+bool JumpPointSearch::Build(const CsrGraph &graph, int cols, int rows, bool precompute){
+
+    Clear();
+    if (cols <= 0 || rows <= 0 || graph.GetNumNodes() != cols*rows || graph.GetNumEdges() == 0){
+        return false;
+    }
+
+    // Cells without edges are treated as blocked, since they cannot be
+    // reached from anywhere else
+    std::vector<unsigned char> passable(cols*rows);
+    for (int n = 0; n < cols*rows; n++){
+        passable[n] = graph.EdgeEnd(n) > graph.EdgeBegin(n);
+    }
+
+    // All straight edges need the same cost, and diagonal edges that
+    // cost times sqrt(2)
+    float cost = graph.GetMinCost();
+    float diagonal_cost = cost*std::sqrt(2.0f);
+    float tolerance = 1e-4f*cost;
+    bool diagonal = false;
+    for (int n = 0; n < cols*rows; n++){
+        int x = n % cols;
+        int y = n / cols;
+        for (uint32_t e = graph.EdgeBegin(n); e < graph.EdgeEnd(n); e++){
+            int m = graph.GetTarget(e);
+            int dx = m % cols - x;
+            int dy = m / cols - y;
+            if (std::abs(dx) > 1 || std::abs(dy) > 1 || (dx == 0 && dy == 0)){
+                return false;
+            }
+            bool is_diagonal = dx != 0 && dy != 0;
+            float expected = is_diagonal ? diagonal_cost : cost;
+            if (std::fabs(graph.GetCost(e) - expected) > tolerance){
+                return false;
+            }
+            diagonal = diagonal || is_diagonal;
+        }
+    }
+
+    // Set up the grid, and check that each cell has an edge for exactly
+    // the moves allowed on it
+    Build(cols, rows, passable, diagonal, cost, false);
+    int num_directions = diagonal_ ? 8 : 4;
+    for (int n = 0; n < cols*rows; n++){
+        int x = n % cols;
+        int y = n / cols;
+        unsigned int seen = 0;
+        for (uint32_t e = graph.EdgeBegin(n); e < graph.EdgeEnd(n); e++){
+            int m = graph.GetTarget(e);
+            int d = DirectionIndex(m % cols - x, m / cols - y);
+            if ((seen & (1 << d)) || !CanMove(x, y, direction_x_g[d], direction_y_g[d])){
+                Clear();
+                return false;
+            }
+            seen |= 1 << d;
+        }
+        for (int d = 0; d < num_directions; d++){
+            if (!(seen & (1 << d)) && passable[n] && CanMove(x, y, direction_x_g[d], direction_y_g[d])){
+                Clear();
+                return false;
+            }
+        }
+    }
+
+    // The graph is a grid
+    if (precompute){
+        Precompute();
+    }
+    return true;
+}
+
+
+void JumpPointSearch::Clear(void){
+
+    cols_ = 0;
+    rows_ = 0;
+    diagonal_ = false;
+    cost_ = 0.0f;
+    diagonal_cost_ = 0.0f;
+    std::vector<unsigned char>().swap(passable_);
+    std::vector<int>().swap(jump_);
+}
+
+
+bool JumpPointSearch::CanMove(int x, int y, int dx, int dy) const {
+
+    if (!IsPassable(x + dx, y + dy)){
+        return false;
+    }
+
+    // Diagonal moves may not cut the corner of a blocked cell
+    if (dx != 0 && dy != 0){
+        return IsPassable(x + dx, y) && IsPassable(x, y + dy);
+    }
+    return true;
+}
+
+
+bool JumpPointSearch::IsForced(int x, int y, int dx, int dy) const {
+
+    // A cell next to the line of movement that is open, while the cell
+    // behind it is blocked, can only be reached optimally by turning here
+    if (dx != 0){
+        return (IsPassable(x, y - 1) && !IsPassable(x - dx, y - 1)) ||
+               (IsPassable(x, y + 1) && !IsPassable(x - dx, y + 1));
+    } else {
+        return (IsPassable(x - 1, y) && !IsPassable(x - 1, y - dy)) ||
+               (IsPassable(x + 1, y) && !IsPassable(x + 1, y - dy));
+    }
+}
+
+
+int JumpPointSearch::Jump(int x, int y, int dx, int dy, int goal) const {
+
+    while (CanMove(x, y, dx, dy)){
+        x += dx;
+        y += dy;
+        int cell = y*cols_ + x;
+        if (cell == goal){
+            return cell;
+        }
+
+        if (dx != 0 && dy != 0){
+            // Moving diagonally, the cell is a jump point if a straight
+            // move from it finds one
+            if (Jump(x, y, dx, 0, goal) != -1 || Jump(x, y, 0, dy, goal) != -1){
+                return cell;
+            }
+        } else {
+            if (IsForced(x, y, dx, dy)){
+                return cell;
+            }
+
+            // On 4-connected grids, vertical moves also need to look for
+            // jump points along each row, since they cannot turn later
+            // with a diagonal move
+            if (!diagonal_ && dy != 0){
+                if (Jump(x, y, 1, 0, goal) != -1 || Jump(x, y, -1, 0, goal) != -1){
+                    return cell;
+                }
+            }
+        }
+    }
+
+    // Ran into a wall
+    return -1;
+}
+
+
+int JumpPointSearch::JumpFromTable(int x, int y, int dx, int dy, int goal) const {
+
+    int num_directions = diagonal_ ? 8 : 4;
+    int distance = jump_[(y*cols_ + x)*num_directions + DirectionIndex(dx, dy)];
+    int span = std::abs(distance);
+    if (span == 0){
+        return -1;
+    }
+
+    // Check if the goal can be reached within the cells covered by the
+    // jump, since the table was built without knowing the goal
+    int gx = goal % cols_;
+    int gy = goal / cols_;
+    int goal_dx = gx - x;
+    int goal_dy = gy - y;
+    if (dx != 0 && dy != 0){
+        // Diagonal move: stop at the cell on the row or column of the
+        // goal, from which a straight move can continue towards it
+        if (Sign(goal_dx) == dx && Sign(goal_dy) == dy){
+            int steps = std::min(std::abs(goal_dx), std::abs(goal_dy));
+            if (steps <= span){
+                return (y + steps*dy)*cols_ + x + steps*dx;
+            }
+        }
+    } else if (dx != 0){
+        // Horizontal move: stop at the goal if it is on the way
+        if (goal_dy == 0 && Sign(goal_dx) == dx && std::abs(goal_dx) <= span){
+            return goal;
+        }
+    } else {
+        // Vertical move: stop at the goal if it is on the way, or on
+        // 4-connected grids at the row of the goal
+        if (Sign(goal_dy) == dy && std::abs(goal_dy) <= span){
+            if (goal_dx == 0){
+                return goal;
+            } else if (!diagonal_){
+                return (y + goal_dy)*cols_ + x;
+            }
+        }
+    }
+
+    // Otherwise, go to the jump point if there is one
+    if (distance > 0){
+        return (y + distance*dy)*cols_ + x + distance*dx;
+    }
+    return -1;
+}
+
+
+void JumpPointSearch::Precompute(void){
+
+    // Each entry is derived from the entry of the next cell in the same
+    // direction, so cells are visited starting from the far side
+    int num_directions = diagonal_ ? 8 : 4;
+    jump_.assign(cols_*rows_*num_directions, 0);
+
+    // Straight moves come first since diagonal moves (and vertical moves
+    // on 4-connected grids) depend on them
+    for (int d = 0; d < num_directions; d++){
+        int dx = direction_x_g[d];
+        int dy = direction_y_g[d];
+        for (int i = 0; i < rows_; i++){
+            int y = dy > 0 ? rows_ - 1 - i : i;
+            for (int j = 0; j < cols_; j++){
+                int x = dx > 0 ? cols_ - 1 - j : j;
+                int &entry = jump_[(y*cols_ + x)*num_directions + d];
+
+                // No step possible
+                if (!CanMove(x, y, dx, dy)){
+                    entry = 0;
+                    continue;
+                }
+
+                // Check if the next cell is a jump point
+                int nx = x + dx;
+                int ny = y + dy;
+                int next = (ny*cols_ + nx)*num_directions;
+                bool jump_point;
+                if (dx != 0 && dy != 0){
+                    jump_point = jump_[next + DirectionIndex(dx, 0)] > 0 || jump_[next + DirectionIndex(0, dy)] > 0;
+                } else {
+                    jump_point = IsForced(nx, ny, dx, dy);
+                    if (!diagonal_ && dy != 0){
+                        jump_point = jump_point || jump_[next + 0] > 0 || jump_[next + 1] > 0;
+                    }
+                }
+
+                // Otherwise, continue the jump of the next cell
+                if (jump_point){
+                    entry = 1;
+                } else {
+                    int distance = jump_[next + d];
+                    entry = distance > 0 ? distance + 1 : distance - 1;
+                }
+            }
+        }
+    }
+}
+
+
+float JumpPointSearch::Estimate(int x1, int y1, int x2, int y2) const {
+
+    // Octile distance on 8-connected grids and Manhattan distance on
+    // 4-connected ones, shrunk slightly against rounding errors
+    float dx = std::abs(x2 - x1);
+    float dy = std::abs(y2 - y1);
+    if (diagonal_){
+        return 0.9999f*(cost_*std::fabs(dx - dy) + diagonal_cost_*std::min(dx, dy));
+    }
+    return 0.9999f*cost_*(dx + dy);
+}
+
+
+bool JumpPointSearch::FindPath(int start, int end, SearchContext &context, std::vector<int> &path, float &cost) const {
+
+    path.clear();
+    if (start == end){
+        path.push_back(start);
+        cost = 0.0f;
+        return true;
+    }
+    if (!passable_[start] || !passable_[end]){
+        return false;
+    }
+
+    // Reset the search state and the queue
+    int num_cells = cols_*rows_;
+    context.Reset(num_cells);
+    QuadHeap &queue = context.GetHeap();
+    queue.Clear(num_cells);
+    SearchStats &stats = context.GetStats();
+    int end_x = end % cols_;
+    int end_y = end / cols_;
+
+    // A* over the jump points
+    context.SetCost(start, 0.0f);
+    queue.Push(start, Estimate(start % cols_, start / cols_, end_x, end_y));
+    stats.pushes++;
+    bool found = false;
+    while (!queue.Empty()){
+        int node;
+        float key;
+        queue.Pop(node, key);
+        stats.pops++;
+        if (context.IsVisited(node)){
+            stats.stale_pops++;
+            continue;
+        }
+        context.SetVisited(node, true);
+        stats.expanded++;
+        if (node == end){
+            found = true;
+            break;
+        }
+
+        // Select the directions worth exploring, based on the direction
+        // in which the node was reached
+        int x = node % cols_;
+        int y = node / cols_;
+        int dir_x[8], dir_y[8];
+        int num_dirs = 0;
+        int prev = context.GetPrev(node);
+        if (prev == -1){
+            // Start node: explore all directions
+            for (int d = 0; d < (diagonal_ ? 8 : 4); d++){
+                dir_x[num_dirs] = direction_x_g[d];
+                dir_y[num_dirs] = direction_y_g[d];
+                num_dirs++;
+            }
+        } else {
+            int dx = Sign(x - prev % cols_);
+            int dy = Sign(y - prev / cols_);
+            if (dx != 0 && dy != 0){
+                // Diagonal: keep going, or go straight along either axis
+                int d[3][2] = {{dx, dy}, {dx, 0}, {0, dy}};
+                for (int k = 0; k < 3; k++){
+                    dir_x[num_dirs] = d[k][0];
+                    dir_y[num_dirs] = d[k][1];
+                    num_dirs++;
+                }
+            } else {
+                // Straight: keep going, or turn to either side, also
+                // diagonally forward on 8-connected grids
+                int px = dy, py = dx; // Perpendicular direction
+                int d[5][2] = {{dx, dy}, {px, py}, {-px, -py}, {dx + px, dy + py}, {dx - px, dy - py}};
+                for (int k = 0; k < (diagonal_ ? 5 : 3); k++){
+                    dir_x[num_dirs] = d[k][0];
+                    dir_y[num_dirs] = d[k][1];
+                    num_dirs++;
+                }
+            }
+        }
+
+        // Jump in each direction and relax the edge to the jump point
+        float node_cost = context.GetCost(node);
+        for (int k = 0; k < num_dirs; k++){
+            int succ = IsPrecomputed() ? JumpFromTable(x, y, dir_x[k], dir_y[k], end) : Jump(x, y, dir_x[k], dir_y[k], end);
+            if (succ == -1){
+                continue;
+            }
+            int sx = succ % cols_;
+            int sy = succ / cols_;
+            int steps = std::max(std::abs(sx - x), std::abs(sy - y));
+            float succ_cost = node_cost + steps*(dir_x[k] != 0 && dir_y[k] != 0 ? diagonal_cost_ : cost_);
+            if (succ_cost < context.GetCost(succ)){
+                context.SetCost(succ, succ_cost);
+                context.SetPrev(succ, node);
+                queue.Push(succ, succ_cost + Estimate(sx, sy, end_x, end_y));
+                stats.pushes++;
+            }
+        }
+    }
+    if (!found){
+        return false;
+    }
+
+    // Fill in the cells between consecutive jump points, which lie on
+    // straight or diagonal lines
+    std::vector<int> jump_points;
+    context.GetPath(end, jump_points);
+    path.push_back(jump_points[0]);
+    for (size_t i = 1; i < jump_points.size(); i++){
+        int x = jump_points[i-1] % cols_;
+        int y = jump_points[i-1] / cols_;
+        int dx = Sign(jump_points[i] % cols_ - x);
+        int dy = Sign(jump_points[i] / cols_ - y);
+        while (y*cols_ + x != jump_points[i]){
+            x += dx;
+            y += dy;
+            path.push_back(y*cols_ + x);
+        }
+    }
+    cost = context.GetCost(end);
+    return true;
+}
+
+} // namespace game
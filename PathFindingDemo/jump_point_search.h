@@ -0,0 +1,104 @@
+#ifndef JUMP_POINT_SEARCH_H_
+#define JUMP_POINT_SEARCH_H_
+
+#include <vector>
+
+#include "csr_graph.h"
+#include "search_context.h"
+
+namespace game {
+
+// Jump Point Search (JPS) on grids where every move has the same cost
+//
+// On such grids, many paths of equal cost connect two cells, and A*
+// spends most of its time expanding all of them. JPS only expands
+// "jump points": cells where an optimal path may have to turn because
+// of a nearby obstacle. Between jump points, the search moves in
+// straight (or diagonal) lines without touching the queue
+//
+// Cell (i, j), in row i and column j, corresponds to node i*cols + j.
+// Grids can be 4-connected, or 8-connected where a diagonal move costs
+// sqrt(2) times a straight move and may not cut the corner of a
+// blocked cell. With precomputation enabled (JPS+), the distance of the
+// jump from each cell in each direction is stored in a table, so that
+// a jump takes constant time instead of scanning the cells
+class JumpPointSearch {
+
+    public:
+        // Create an empty search that is not ready to be used
+        JumpPointSearch(void);
+
+        // Set up the search for a grid with cols x rows cells, where
+        // passable flags the cells that can be entered, and cost is the
+        // cost of a straight move
+        void Build(int cols, int rows, const std::vector<unsigned char> &passable, bool diagonal, float cost, bool precompute);
+
+        // Set up the search for a compact graph laid out as a grid, if
+        // the graph allows it. This is the case if all edges connect
+        // neighboring cells with the same cost (times sqrt(2) for
+        // diagonals), and exactly the moves allowed between cells that
+        // have edges are present. Returns false otherwise, and the
+        // search is left not ready
+        bool Build(const CsrGraph &graph, int cols, int rows, bool precompute);
+
+        // Release all memory and make the search not ready
+        void Clear(void);
+
+        // Check if the search was set up
+        inline bool IsReady(void) const { return cols_ > 0; }
+        inline bool IsDiagonal(void) const { return diagonal_; }
+        inline bool IsPrecomputed(void) const { return !jump_.empty(); }
+
+        // Find a shortest path between the cells with indices start and
+        // end, using the given context for the search state
+        // The path lists every cell from start to end, as a search on the
+        // graph would. Returns false if there is no path
+        bool FindPath(int start, int end, SearchContext &context, std::vector<int> &path, float &cost) const;
+
+    private:
+        // Size of the grid
+        int cols_, rows_;
+
+        // Flag for each cell indicating whether it can be entered
+        std::vector<unsigned char> passable_;
+
+        // Flag for 8-connected grids
+        bool diagonal_;
+
+        // Cost of a straight move and of a diagonal move
+        float cost_, diagonal_cost_;
+
+        // Jump table for JPS+, with one entry per cell and direction
+        // A positive entry is the number of steps to the next jump point,
+        // otherwise its negation is the number of steps to a wall
+        std::vector<int> jump_;
+
+        // Check if the cell at (x, y) exists and can be entered
+        inline bool IsPassable(int x, int y) const { return x >= 0 && x < cols_ && y >= 0 && y < rows_ && passable_[y*cols_ + x]; }
+
+        // Check if a move from (x, y) in direction (dx, dy) is allowed
+        bool CanMove(int x, int y, int dx, int dy) const;
+
+        // Check if cell (x, y), entered with a straight move in direction
+        // (dx, dy), has a neighbor that forces the path to turn
+        bool IsForced(int x, int y, int dx, int dy) const;
+
+        // Move from (x, y) in direction (dx, dy) until a jump point or
+        // the goal cell is found, and return its index, or -1 if the move
+        // runs into a wall
+        int Jump(int x, int y, int dx, int dy, int goal) const;
+
+        // Find the successor of cell (x, y) in direction (dx, dy) using
+        // the jump table, or -1 if there is none
+        int JumpFromTable(int x, int y, int dx, int dy, int goal) const;
+
+        // Fill the jump table for all cells and directions
+        void Precompute(void);
+
+        // Estimate the cost between two cells
+        float Estimate(int x1, int y1, int x2, int y2) const;
+};
+
+} // namespace game
+
+#endif // JUMP_POINT_SEARCH_H_
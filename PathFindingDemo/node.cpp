@@ -1,19 +1,29 @@
-#include <climits>
-
 #include "node.h"
 
 namespace game {
 
-Node::Node(int id, float x, float y) : id_(id) {
+Node::Node(int id, float x, float y, Arena *arena, int edge_capacity) : id_(id) {
 
     // Initialize private members
-    // edge_ is automatically initialized
     x_ = x;
     y_ = y;
-    visited_ = false;
-    cost_ = INT_MAX;
-    on_path_ = false;
-    prev_ = nullptr;
+    arena_ = arena;
+    num_edges_ = 0;
+    edge_capacity_ = edge_capacity;
+    edge_ = edge_capacity > 0 ? arena_->Allocate<Edge>(edge_capacity) : NULL;
+}
+
+
+void Node::Grow(void) {
+
+    // Start with room for the neighbors of a grid node
+    int capacity = edge_capacity_ > 0 ? 2*edge_capacity_ : 4;
+    Edge *edge = arena_->Allocate<Edge>(capacity);
+    for (int i = 0; i < num_edges_; i++) {
+        edge[i] = edge_[i];
+    }
+    edge_ = edge;
+    edge_capacity_ = capacity;
 }
 
 
@@ -31,4 +41,25 @@ void Node::AddNeighbor(Node *n, float edge_cost) {
     n->AddEdge(e);
 }
 
+
+bool Node::SetEdgeCost(Node *n, float edge_cost) {
+
+    // Update the edges in this node
+    bool found = false;
+    for (int i = 0; i < num_edges_; i++) {
+        if (edge_[i].n2 == n) {
+            edge_[i].cost = edge_cost;
+            found = true;
+        }
+    }
+
+    // Update the symmetric edges in the other node
+    for (int i = 0; i < n->num_edges_; i++) {
+        if (n->edge_[i].n2 == this) {
+            n->edge_[i].cost = edge_cost;
+        }
+    }
+    return found;
+}
+
 } // namespace game
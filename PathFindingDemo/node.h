@@ -1,7 +1,7 @@
 #ifndef NODE_H_
 #define NODE_H_
 
-#include <vector>
+#include "arena.h"
 
 namespace game {
 
@@ -16,11 +16,20 @@ struct Edge {
 };
 
 // A node in a graph
+//
+// The edges of the node are stored in an array allocated from the given
+// arena, which is usually owned by the Graph. When the array is full,
+// a new array of twice the size is allocated and the old one is left
+// to the arena, so nodes never free memory themselves
+//
+// A node only holds the edges added since its graph was last compiled:
+// Graph::Compile() moves them to the compact graph and releases them
 class Node {
 
     public:
-        // Create a node at position (x, y)
-        Node(int id, float x, float y);
+        // Create a node at position (x, y), with room for edge_capacity
+        // edges allocated from arena
+        Node(int id, float x, float y, Arena *arena, int edge_capacity = 0);
 
         // Connects two nodes with an edge that has the given cost
         //
@@ -28,36 +37,38 @@ class Node {
         // to the other node
         void AddNeighbor(Node *n, float edge_cost);
 
+        // Change the cost of the edges between this node and node n,
+        // in both directions. Returns false if they are not connected
+        bool SetEdgeCost(Node *n, float edge_cost);
+
         // Connects two nodes together with a given edge
-        inline void AddEdge(const Edge &e) { edge_.push_back(e); }
+        inline void AddEdge(const Edge &e) { if (num_edges_ == edge_capacity_) { Grow(); } edge_[num_edges_++] = e; }
 
         // Get neighborhood information for this node
-        inline int GetNumEdges(void) { return edge_.size(); }
+        // Only covers the edges added since the graph was compiled, use
+        // Graph::GetCompiledGraph() for all the edges
+        inline int GetNumEdges(void) { return num_edges_; }
         inline const Edge &GetEdge(int index) { return edge_[index]; }
+
+        // Forget the edges once they were copied elsewhere
+        // Their memory belongs to the arena, which releases it
+        inline void ReleaseEdges(void) { edge_ = NULL; num_edges_ = 0; edge_capacity_ = 0; }
        
         // Getters for node properties
         inline int GetId(void) const { return id_; }
         inline float GetX(void) const { return x_; }
         inline float GetY(void) const { return y_; }
-        inline bool GetVisited(void) const { return visited_; }
-        inline float GetCost(void) const { return cost_; }
-        inline bool IsOnPath(void) const { return on_path_; }
-        inline Node* GetPrev(void) { return prev_; }
-
-        // Setters for node properties
-        inline void SetX(float x) { x_ = x; }
-        inline void SetY(float y) { y_ = y; }
-        inline void SetPosition(float x, float y) { x_ = x; y_ = y; }
-        inline void SetVisited(bool visited) { visited_ = visited; }
-        inline void SetCost(float cost) { cost_ = cost; }
-        inline void SetOnPath(bool path_status) { on_path_ = path_status; }
-        inline void SetPrev(Node* node) { prev_ = node; }
 
     protected:
-        // Vector containing all edges the node connects to
+        // Array containing all edges the node connects to
         // This can be used to create a graph where nodes have any
         // number of neighbors
-        std::vector<Edge> edge_;
+        Edge *edge_;
+        int num_edges_;
+        int edge_capacity_;
+
+        // Arena that the edge array is allocated from
+        Arena *arena_;
 
         // Unique id of the node
         const int id_;
@@ -65,19 +76,18 @@ class Node {
         // Position of the node
         float x_, y_;
 
-        // Flag for graph traversals
-        bool visited_;
+        // State of graph traversals (cost, previous node on the path,
+        // visited flag) is kept in a SearchContext rather than in the
+        // node, so that the graph can be shared by concurrent searches
 
-        // Members for computing shortest paths
+        // Move the edges to an array twice as large
+        void Grow(void);
 
-        // Cost of the node
-        float cost_;
-
-        // Node is on path
-        bool on_path_;
-
-        // Link to previous node on path
-        Node* prev_;
+    private:
+        // Only the graph moves its nodes, through Graph::SetPosition, so
+        // that its spatial index stays up to date
+        friend class Graph;
+        inline void SetPosition(float x, float y) { x_ = x; y_ = y; }
 }; 
 
 } // namespace game
@@ -0,0 +1,250 @@
+/*
+ *
+ * Offscreen check of the graph rendering
+ *
+ * Draws the demo graph without a window, once with a game object per node
+ * and edge and once with the instanced shader, and compares the pixels of
+ * both. Needs EGL with the surfaceless platform of Mesa, so that it also
+ * runs on machines without a display, for example with llvmpipe. Returns
+ * 0 if the images match in every frame, and 1 otherwise
+ *
+ * Build it with the OFFSCREEN_CHECK option of CMake
+ *
+ */
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#define GLEW_STATIC
+#include <GL/glew.h>
+#define GLM_FORCE_RADIANS
+#include <glm/gtc/matrix_transform.hpp>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+#include <path_config.h>
+
+#include "gl_state.h"
+#include "sprite.h"
+#include "shader.h"
+#include "frame_uniforms.h"
+#include "game_object.h"
+#include "graph_view.h"
+
+using namespace game;
+
+// Size of the image, the same as the window of the demo
+const int image_width_g = 1024;
+const int image_height_g = 768;
+
+// Largest difference allowed in one color channel, since the instanced
+// shader reads the color modifiers as bytes
+const int channel_tolerance_g = 2;
+
+// Directory with the shaders
+const std::string resources_directory_g = RESOURCES_DIRECTORY;
+
+
+// Create an OpenGL context without a surface, and a framebuffer with
+// color and depth to draw into
+void InitContext(void){
+
+    PFNEGLGETPLATFORMDISPLAYEXTPROC get_platform_display = (PFNEGLGETPLATFORMDISPLAYEXTPROC) eglGetProcAddress("eglGetPlatformDisplayEXT");
+    if (!get_platform_display) {
+        throw(std::runtime_error(std::string("EGL does not support platform displays")));
+    }
+    EGLDisplay display = get_platform_display(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+    EGLint major, minor;
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor)) {
+        throw(std::runtime_error(std::string("Could not initialize the surfaceless EGL display")));
+    }
+    eglBindAPI(EGL_OPENGL_API);
+
+    // The demo shaders need OpenGL 3.3
+    EGLint attributes[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 3,
+        EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_COMPATIBILITY_PROFILE_BIT,
+        EGL_NONE
+    };
+    EGLContext context = eglCreateContext(display, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, attributes);
+    if (context == EGL_NO_CONTEXT || !eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context)) {
+        throw(std::runtime_error(std::string("Could not create an OpenGL 3.3 context")));
+    }
+
+    // Only the function pointers are needed, so a missing GLX display
+    // is not an error
+    glewExperimental = GL_TRUE;
+    GLenum err = glewInit();
+#ifdef GLEW_ERROR_NO_GLX_DISPLAY
+    if (err == GLEW_ERROR_NO_GLX_DISPLAY) {
+        err = GLEW_OK;
+    }
+#endif
+    if (err != GLEW_OK) {
+        throw(std::runtime_error(std::string("Could not initialize the GLEW library: ") + std::string((const char *)glewGetErrorString(err))));
+    }
+
+    GLuint framebuffer, renderbuffer[2];
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glGenRenderbuffers(2, renderbuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, renderbuffer[0]);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, image_width_g, image_height_g);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, renderbuffer[0]);
+    glBindRenderbuffer(GL_RENDERBUFFER, renderbuffer[1]);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, image_width_g, image_height_g);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, renderbuffer[1]);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        throw(std::runtime_error(std::string("Could not create the framebuffer")));
+    }
+    glViewport(0, 0, image_width_g, image_height_g);
+}
+
+
+// Create a 32x32 texture with a disc for the nodes, or a horizontal bar
+// for the edges, so that the check does not depend on image files
+GLuint CreateTexture(bool disc){
+
+    std::vector<unsigned char> pixels(32*32*4);
+    for (int y = 0; y < 32; y++) {
+        for (int x = 0; x < 32; x++) {
+            float dx = x - 15.5f;
+            float dy = y - 15.5f;
+            bool inside = disc ? dx*dx + dy*dy < 60.0f : (y > 13 && y < 18);
+            unsigned char *p = &pixels[(y*32 + x)*4];
+            p[0] = 200;
+            p[1] = 220;
+            p[2] = 240;
+            p[3] = inside ? 255 : 0;
+        }
+    }
+
+    GLuint texture;
+    glGenTextures(1, &texture);
+    GLState::BindTexture(texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 32, 32, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    return texture;
+}
+
+
+// Draw the graph with a view and read back the image
+std::vector<unsigned char> Draw(GraphView &view, FrameUniforms &frame_uniforms, const glm::mat4 &view_matrix){
+
+    frame_uniforms.Update(view_matrix, 0.0f);
+    glClearColor(0.4f, 0.4f, 0.4f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    view.Render(view_matrix, 0.0);
+
+    std::vector<unsigned char> image(image_width_g*image_height_g*4);
+    glReadPixels(0, 0, image_width_g, image_height_g, GL_RGBA, GL_UNSIGNED_BYTE, image.data());
+    GLenum err = glGetError();
+    if (err != GL_NO_ERROR) {
+        throw(std::runtime_error(std::string("OpenGL error ") + std::to_string(err)));
+    }
+    return image;
+}
+
+
+// Draw the graph with both views and compare the images
+// Returns true if they match
+bool Compare(const char *name, GraphView &objects, GraphView &instanced, FrameUniforms &frame_uniforms, const glm::mat4 &view_matrix){
+
+    std::vector<unsigned char> expected = Draw(objects, frame_uniforms, view_matrix);
+    std::vector<unsigned char> result = Draw(instanced, frame_uniforms, view_matrix);
+
+    // Count the pixels that differ, and those covered by the graph to
+    // make sure that something was drawn
+    int differ = 0, drawn = 0;
+    for (int i = 0; i < (int) expected.size(); i += 4) {
+        bool same = true;
+        for (int c = 0; c < 3; c++) {
+            same = same && std::abs(expected[i + c] - result[i + c]) <= channel_tolerance_g;
+        }
+        differ += same ? 0 : 1;
+        drawn += (expected[i] != expected[i + 1]) ? 1 : 0;
+    }
+
+    bool ok = differ == 0 && drawn > 0;
+    std::cout << name << ": " << drawn << " pixels drawn, " << differ << " differ" << (ok ? "" : "  FAILED") << std::endl;
+    return ok;
+}
+
+
+int main(void){
+
+    try {
+        InitContext();
+
+        // Set up the sprites and shaders of the demo
+        FrameUniforms frame_uniforms;
+        frame_uniforms.Init();
+        Sprite sprite;
+        sprite.CreateGeometry();
+        Shader sprite_shader;
+        sprite_shader.Init((resources_directory_g+std::string("/sprite_vertex_shader.glsl")).c_str(), (resources_directory_g+std::string("/sprite_fragment_shader.glsl")).c_str());
+        Shader graph_shader;
+        graph_shader.Init((resources_directory_g+std::string("/graph_vertex_shader.glsl")).c_str(), (resources_directory_g+std::string("/graph_fragment_shader.glsl")).c_str());
+        GameObject node_sprite(glm::vec3(0.0f, 0.0f, 0.0f), &sprite, &sprite_shader, CreateTexture(true));
+        node_sprite.SetScale(0.5);
+        GameObject edge_sprite(glm::vec3(0.0f, 0.0f, 0.0f), &sprite, &sprite_shader, CreateTexture(false));
+        edge_sprite.SetScale(0.5);
+
+        // Same graph and camera as the demo
+        Graph g;
+        g.BuildGrid(18, 14, 0.5, 0.5, -4.25, 0.75, 4);
+        glm::mat4 view_matrix = glm::scale(glm::mat4(1.0f), glm::vec3((float) image_height_g/image_width_g, 1.0f, 1.0f));
+        view_matrix = glm::scale(view_matrix, glm::vec3(0.25f, 0.25f, 0.25f));
+
+        GraphView objects;
+        objects.Attach(&g, &node_sprite, &edge_sprite);
+        GraphView instanced;
+        instanced.Attach(&g, &node_sprite, &edge_sprite, &graph_shader);
+
+        bool ok = true;
+
+        // First frame, which builds the instance buffers
+        g.SetStartNode(g.GetNode(20));
+        g.SetEndNode(g.GetNode(200));
+        g.FindPath();
+        ok = Compare("path", objects, instanced, frame_uniforms, view_matrix) && ok;
+
+        // Another path, which only updates the colors that changed
+        g.SetStartNode(g.GetNode(5));
+        g.SetEndNode(g.GetNode(240));
+        g.FindPath();
+        ok = Compare("new path", objects, instanced, frame_uniforms, view_matrix) && ok;
+
+        // Edge costs do not move the sprites, but change the path. The
+        // vertical edges under a part of row 5 get expensive
+        for (int i = 100; i < 110; i++) {
+            g.SetEdgeCost(i, i + 18, 50.0f);
+        }
+        g.FindPath();
+        ok = Compare("edge costs", objects, instanced, frame_uniforms, view_matrix) && ok;
+
+        // Nodes and edges added after the search are only drawn once the
+        // graph is compiled again, and drawing must not compile it
+        Node *node = g.AddNode(g.GetNumNodes(), 5.0f, 4.25f);
+        node->AddNeighbor(g.GetNode(g.GetNumNodes() - 2), 1.0f);
+        g.GetNode(g.GetNumNodes() - 2)->AddNeighbor(node, 1.0f);
+        ok = Compare("added node", objects, instanced, frame_uniforms, view_matrix) && ok;
+        if (g.IsCompiled()) {
+            std::cout << "added node: drawing compiled the graph  FAILED" << std::endl;
+            ok = false;
+        }
+        g.FindPath();
+        ok = Compare("compiled", objects, instanced, frame_uniforms, view_matrix) && ok;
+
+        return ok ? 0 : 1;
+    }
+    catch (std::exception &e){
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+}
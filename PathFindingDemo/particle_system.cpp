@@ -1,6 +1,7 @@
 #define GLM_FORCE_RADIANS
 #include <glm/gtc/matrix_transform.hpp>
 
+#include "gl_state.h"
 #include "particle_system.h"
 
 
@@ -23,11 +24,9 @@ void ParticleSystem::Update(double delta_time) {
 void ParticleSystem::Render(glm::mat4 view_matrix, double current_time){
 
     // Set up the shader
+    // The view matrix and the time are read from the frame uniforms
     shader_->Enable();
 
-    // Set up the view matrix
-    shader_->SetUniformMat4("view_matrix", view_matrix);
-
     // Setup the scaling matrix for the shader
     glm::mat4 scaling_matrix = glm::scale(glm::mat4(1.0f), glm::vec3(scale_, scale_, 1.0));
 
@@ -46,16 +45,13 @@ void ParticleSystem::Render(glm::mat4 view_matrix, double current_time){
     glm::mat4 transformation_matrix = parent_transformation_matrix * translation_matrix * rotation_matrix * scaling_matrix;
 
     // Set the transformation matrix in the shader
-    shader_->SetUniformMat4("transformation_matrix", transformation_matrix);
-
-    // Set the time in the shader
-    shader_->SetUniform1f("time", current_time);
+    shader_->SetUniformMat4(transformation_matrix_location_, transformation_matrix);
 
     // Set up the geometry
-    geometry_->SetGeometry(shader_->GetShaderProgram());
+    geometry_->SetGeometry(shader_);
 
     // Bind the particle texture
-    glBindTexture(GL_TEXTURE_2D, texture_);
+    GLState::BindTexture(texture_);
 
     // Draw the entity
     glDrawElements(GL_TRIANGLES, geometry_->GetSize(), GL_UNSIGNED_INT, 0);
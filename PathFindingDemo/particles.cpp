@@ -2,6 +2,7 @@
 #include <string>
 #include <glm/gtc/type_ptr.hpp>
 
+#include "gl_state.h"
 #include "particles.h"
 
 namespace game {
@@ -84,7 +85,9 @@ void Particles::CreateGeometry(void)
         }
     }
 
-    // Create buffer for vertices
+    // Create buffer for vertices, outside of any vertex array so that the
+    // index buffer binding does not change one
+    GLState::BindVertexArray(0);
     glGenBuffers(1, &vbo_);
     glBindBuffer(GL_ARRAY_BUFFER, vbo_);
     glBufferData(GL_ARRAY_BUFFER, sizeof(particles), particles, GL_STATIC_DRAW);
@@ -99,37 +102,24 @@ void Particles::CreateGeometry(void)
 }
 
 
-void Particles::SetGeometry(GLuint shader_program){
+void Particles::SetState(void){
 
     // Set blending
-    glDisable(GL_DEPTH_TEST);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_ONE, GL_ONE);
+    GLState::DisableDepthTest();
+    GLState::EnableBlend(GL_ONE, GL_ONE);
+}
 
-    // Bind buffers
-    glBindBuffer(GL_ARRAY_BUFFER, vbo_);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo_);
 
-    // Set attributes for shaders
-    // Should be consistent with how we created the buffers for the particle elements
-    GLint vertex_att = glGetAttribLocation(shader_program, "vertex");
-    glVertexAttribPointer(vertex_att, 2, GL_FLOAT, GL_FALSE, 7 * sizeof(GLfloat), 0);
-    glEnableVertexAttribArray(vertex_att);
+void Particles::SetAttributes(const Shader *shader){
 
+    // Should be consistent with how we created the buffers for the particle elements
+    SetAttribute(shader, "vertex", 2, 7, 0);
     // Direction
-    GLint dir_att = glGetAttribLocation(shader_program, "dir");
-    glVertexAttribPointer(dir_att, 2, GL_FLOAT, GL_FALSE, 7 * sizeof(GLfloat), (void *)(2 * sizeof(GLfloat)));
-    glEnableVertexAttribArray(dir_att);
-
-    // Phase 
-    GLint time_att = glGetAttribLocation(shader_program, "t");
-    glVertexAttribPointer(time_att, 1, GL_FLOAT, GL_FALSE, 7 * sizeof(GLfloat), (void *)(4 * sizeof(GLfloat)));
-    glEnableVertexAttribArray(time_att);
-
+    SetAttribute(shader, "dir", 2, 7, 2);
+    // Phase
+    SetAttribute(shader, "t", 1, 7, 4);
     // Texture coordinates
-    GLint tex_att = glGetAttribLocation(shader_program, "uv");
-    glVertexAttribPointer(tex_att, 2, GL_FLOAT, GL_FALSE, 7 * sizeof(GLfloat), (void *)(5 * sizeof(GLfloat)));
-    glEnableVertexAttribArray(tex_att);
+    SetAttribute(shader, "uv", 2, 7, 5);
 }
 
 } // namespace game
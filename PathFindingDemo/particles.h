@@ -16,8 +16,12 @@ namespace game {
             // Create the geometry (called once)
             void CreateGeometry(void);
 
-            // Use the geometry
-            void SetGeometry(GLuint shader_program);
+            // Draw with additive blending and without depth test
+            void SetState(void);
+
+        protected:
+            // Set the attributes of the particle elements
+            void SetAttributes(const Shader *shader);
 
     }; // class Particles
 } // namespace game
@@ -0,0 +1,155 @@
+#include "path_cache.h"
+
+namespace game {
+
+PathCache::PathCache(size_t max_bytes){
+
+    max_bytes_ = 0;
+    for (int i = 0; i < path_cache_shards_g; i++){
+        shard_[i].bytes = 0;
+        shard_[i].max_bytes = 0;
+        shard_[i].stats = PathCacheStats();
+    }
+    SetBudget(max_bytes);
+}
+
+
+void PathCache::SetBudget(size_t max_bytes){
+
+    // Each shard gets an equal part of the budget
+    size_t shard_bytes = (max_bytes + path_cache_shards_g - 1)/path_cache_shards_g;
+    for (int i = 0; i < path_cache_shards_g; i++){
+        std::lock_guard<std::mutex> lock(shard_[i].mutex);
+        shard_[i].max_bytes = shard_bytes;
+        Evict(shard_[i]);
+    }
+    max_bytes_.store(max_bytes, std::memory_order_relaxed);
+}
+
+
+bool PathCache::Find(int start, int end, unsigned int version, bool &found, std::vector<int> &path, float &cost){
+
+    // A disabled cache does not count misses, and takes no lock
+    if (!IsEnabled()){
+        return false;
+    }
+
+    uint64_t key = Key(start, end);
+    Shard &shard = GetShard(key);
+    std::shared_ptr<const std::vector<int> > result;
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        std::unordered_map<uint64_t, std::list<Entry>::iterator>::iterator it = shard.index.find(key);
+        if (it == shard.index.end()){
+            shard.stats.misses++;
+            return false;
+        }
+
+        // Drop the result of an older graph
+        std::list<Entry>::iterator entry = it->second;
+        if (entry->version != version){
+            Erase(shard, entry);
+            shard.stats.stale++;
+            shard.stats.misses++;
+            return false;
+        }
+
+        // Move the entry to the front of the list
+        shard.lru.splice(shard.lru.begin(), shard.lru, entry);
+        found = entry->found;
+        cost = entry->cost;
+        result = entry->path;
+        shard.stats.hits++;
+    }
+
+    // The shared path stays valid after an eviction, so it is copied
+    // without holding the lock
+    path.assign(result->begin(), result->end());
+    return true;
+}
+
+
+void PathCache::Insert(int start, int end, unsigned int version, bool found, const std::vector<int> &path, float cost){
+
+    if (!IsEnabled()){
+        return;
+    }
+
+    // Copy the path without spare capacity, before taking the lock
+    Entry e;
+    e.key = Key(start, end);
+    e.version = version;
+    e.found = found;
+    e.cost = cost;
+    e.path = std::make_shared<const std::vector<int> >(path.begin(), path.end());
+    size_t size = Size(e);
+
+    Shard &shard = GetShard(e.key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    // Replace the previous result
+    std::unordered_map<uint64_t, std::list<Entry>::iterator>::iterator it = shard.index.find(e.key);
+    if (it != shard.index.end()){
+        Erase(shard, it->second);
+    }
+    shard.lru.push_front(e);
+    shard.index[e.key] = shard.lru.begin();
+    shard.bytes += size;
+    Evict(shard);
+}
+
+
+void PathCache::Clear(void){
+
+    for (int i = 0; i < path_cache_shards_g; i++){
+        std::lock_guard<std::mutex> lock(shard_[i].mutex);
+        shard_[i].lru.clear();
+        shard_[i].index.clear();
+        shard_[i].bytes = 0;
+        shard_[i].stats = PathCacheStats();
+    }
+}
+
+
+PathCacheStats PathCache::GetStats(void) const {
+
+    PathCacheStats stats = PathCacheStats();
+    for (int i = 0; i < path_cache_shards_g; i++){
+        std::lock_guard<std::mutex> lock(shard_[i].mutex);
+        stats.hits += shard_[i].stats.hits;
+        stats.misses += shard_[i].stats.misses;
+        stats.stale += shard_[i].stats.stale;
+        stats.evictions += shard_[i].stats.evictions;
+    }
+    return stats;
+}
+
+
+size_t PathCache::GetMemory(void) const {
+
+    size_t bytes = 0;
+    for (int i = 0; i < path_cache_shards_g; i++){
+        std::lock_guard<std::mutex> lock(shard_[i].mutex);
+        bytes += shard_[i].bytes;
+    }
+    return bytes;
+}
+
+
+void PathCache::Erase(Shard &shard, std::list<Entry>::iterator it){
+
+    shard.bytes -= Size(*it);
+    shard.index.erase(it->key);
+    shard.lru.erase(it);
+}
+
+
+void PathCache::Evict(Shard &shard){
+
+    while (shard.bytes > shard.max_bytes && !shard.lru.empty()){
+        Erase(shard, --shard.lru.end());
+        shard.stats.evictions++;
+    }
+}
+
+} // namespace game
@@ -0,0 +1,124 @@
+#ifndef PATH_CACHE_H_
+#define PATH_CACHE_H_
+
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <mutex>
+#include <memory>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+namespace game {
+
+// Number of independently locked parts of a path cache
+const int path_cache_shards_g = 16;
+
+// Counters of a path cache
+struct PathCacheStats {
+    long hits; // Lookups answered by the cache
+    long misses; // Lookups that found nothing, including stale entries
+    long stale; // Entries dropped because the graph changed
+    long evictions; // Entries dropped to stay within the memory budget
+};
+
+
+// Least-recently-used cache of path query results
+//
+// Each entry stores the result of a query from a start node to an end
+// node, together with the version of the graph it was computed on. An
+// entry found for another version is outdated, so it is dropped and
+// counted as a miss; a graph therefore only needs to increase its
+// version when it changes, instead of clearing the cache. When the
+// entries take more memory than the budget, the least recently used
+// ones are evicted. All methods can be called from several threads
+//
+// The entries are spread over path_cache_shards_g shards by start and
+// end node, each with its own lock, LRU order and an equal part of the
+// budget, so that concurrent queries rarely wait for each other. Paths
+// are shared between the cache and its lookups, and copied outside of
+// the locks. A disabled cache takes no lock at all
+class PathCache {
+
+    public:
+        // Create an empty cache with the given memory budget in bytes
+        PathCache(size_t max_bytes = 0);
+
+        // Change the memory budget, evicting entries if needed
+        // A budget of 0 disables the cache
+        void SetBudget(size_t max_bytes);
+        inline size_t GetBudget(void) const { return max_bytes_.load(std::memory_order_relaxed); }
+        inline bool IsEnabled(void) const { return GetBudget() > 0; }
+
+        // Look up the result of the query from start to end on the given
+        // version of the graph. On a hit, found tells if there is a path,
+        // and the path and its cost are copied. Returns false on a miss
+        bool Find(int start, int end, unsigned int version, bool &found, std::vector<int> &path, float &cost);
+
+        // Store the result of a query, replacing any previous result for
+        // the same start and end nodes
+        void Insert(int start, int end, unsigned int version, bool found, const std::vector<int> &path, float cost);
+
+        // Remove all entries and reset the statistics
+        void Clear(void);
+
+        // Get the statistics and the memory taken by the entries
+        PathCacheStats GetStats(void) const;
+        size_t GetMemory(void) const;
+
+    private:
+        // Result of a query
+        struct Entry {
+            uint64_t key; // Start and end nodes
+            unsigned int version; // Version of the graph
+            bool found; // Flag indicating that there is a path
+            float cost; // Cost of the path
+            std::shared_ptr<const std::vector<int> > path; // Node indices on the path
+        };
+
+        // Part of the cache with its own lock
+        struct Shard {
+            // Lock protecting all the members below
+            mutable std::mutex mutex;
+
+            // Entries from the most to the least recently used, and
+            // their positions by key
+            std::list<Entry> lru;
+            std::unordered_map<uint64_t, std::list<Entry>::iterator> index;
+
+            // Memory taken by the entries, and the budget of the shard
+            size_t bytes;
+            size_t max_bytes;
+
+            // Statistics
+            PathCacheStats stats;
+        };
+
+        // Total budget, read without locking
+        std::atomic<size_t> max_bytes_;
+
+        // Shards of the cache
+        Shard shard_[path_cache_shards_g];
+
+        // Combine the start and end nodes into a key
+        static inline uint64_t Key(int start, int end) { return ((uint64_t) (uint32_t) start << 32) | (uint32_t) end; }
+
+        // Get the shard holding the given key
+        inline Shard &GetShard(uint64_t key) { return shard_[((key * 0x9E3779B97F4A7C15ull) >> 32) % path_cache_shards_g]; }
+
+        // Estimate the memory taken by an entry, including the list and
+        // map nodes and the shared path
+        static inline size_t Size(const Entry &e) { return sizeof(Entry) + e.path->capacity()*sizeof(int) + 12*sizeof(void*); }
+
+        // Remove an entry of a shard
+        static void Erase(Shard &shard, std::list<Entry>::iterator it);
+
+        // Evict the least recently used entries of a shard until it is
+        // within its budget
+        static void Evict(Shard &shard);
+};
+
+} // namespace game
+
+#endif // PATH_CACHE_H_
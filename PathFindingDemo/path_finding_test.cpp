@@ -0,0 +1,597 @@
+/*
+ *
+ * Tests of the path finding library
+ *
+ * Every search strategy is compared with Dijkstra's algorithm on the
+ * indexed heap, which is simple enough to serve as the reference: on
+ * random graphs and on grids, each strategy has to find a path with the
+ * same cost, or no path when the reference finds none, and the paths it
+ * returns have to follow edges of the graph. Returns 0 if all checks
+ * pass, and 1 otherwise
+ *
+ * Built with the library, also with the HEADLESS option, and run by
+ * ctest
+ *
+ */
+
+#include <algorithm>
+#include <stdexcept>
+#include <set>
+#include <utility>
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+#include "graph.h"
+#include "grid_graph.h"
+#include "dijkstra.h"
+#include "astar.h"
+#include "bidirectional_search.h"
+
+using namespace game;
+
+// Relative difference allowed between the costs of two paths, since
+// the searches add up the edge costs in different orders
+const float cost_tolerance_g = 1e-4f;
+
+// Number of queries run on each graph
+const int num_queries_g = 200;
+
+
+// Check if two path costs are the same, where INFINITY means that there
+// is no path
+bool SameCost(float a, float b){
+
+    if (a == INFINITY || b == INFINITY) {
+        return a == b;
+    }
+    return std::fabs(a - b) <= cost_tolerance_g*std::max(1.0f, std::fabs(a));
+}
+
+
+// Add up the costs of the edges along a path, taking the cheapest edge
+// between two nodes. Returns INFINITY if two consecutive nodes are not
+// connected, or if the path does not go from start to end
+template <typename GraphType>
+float PathCost(const GraphType &graph, int start, int end, const std::vector<int> &path){
+
+    if (path.empty() || path.front() != start || path.back() != end) {
+        return INFINITY;
+    }
+    float total = 0.0f;
+    for (size_t i = 1; i < path.size(); i++) {
+        float best = INFINITY;
+        for (uint32_t e = graph.EdgeBegin(path[i-1]); e < graph.EdgeEnd(path[i-1]); e++) {
+            if (graph.GetTarget(e) == path[i]) {
+                best = std::min(best, graph.GetCost(e));
+            }
+        }
+        total += best;
+    }
+    return total;
+}
+
+
+// Cost of the shortest path found by Dijkstra's algorithm on the indexed
+// heap, or INFINITY if there is none
+template <typename GraphType>
+float ReferenceCost(const GraphType &graph, int start, int end, SearchContext &context){
+
+    if (!Dijkstra(graph, start, end, context.GetHeap(), context)) {
+        return INFINITY;
+    }
+    return context.GetCost(end);
+}
+
+
+// Count a failed check, and print the query the first few times
+void Fail(int &failures, const char *name, int start, int end, float expected, float result){
+
+    if (failures < 5) {
+        std::cout << "  " << name << " from " << start << " to " << end << ": cost " << result << ", expected " << expected << std::endl;
+    }
+    failures++;
+}
+
+
+// Print the result of a test. Returns true if it passed
+bool Report(const char *name, int checks, int failures){
+
+    std::cout << name << ": " << checks << " checks, " << failures << " failed" << (failures == 0 ? "" : "  FAILED") << std::endl;
+    return failures == 0;
+}
+
+
+// Build a graph with nodes at random positions and random edges
+// With integer costs, the edges cost 1 to 20, otherwise their length
+// times a random factor, so that the heuristics have some slack
+// Some nodes may not be connected to the others
+void BuildRandomGraph(Graph &graph, int num_nodes, int num_edges, bool integer_costs){
+
+    for (int i = 0; i < num_nodes; i++) {
+        graph.AddNode(i, (float) (rand() % 1000)/10.0f, (float) (rand() % 1000)/10.0f);
+    }
+
+    // Connect each pair of nodes at most once, so that SetEdgeCost can
+    // change the cost between them
+    std::set<std::pair<int, int> > connected;
+    while ((int) connected.size() < num_edges) {
+        int a = rand() % num_nodes;
+        int b = rand() % num_nodes;
+        if (a == b || !connected.insert(std::make_pair(std::min(a, b), std::max(a, b))).second) {
+            continue;
+        }
+        Node *n1 = graph.GetNode(a);
+        Node *n2 = graph.GetNode(b);
+        float cost;
+        if (integer_costs) {
+            cost = (float) (1 + rand() % 20);
+        } else {
+            float dx = n2->GetX() - n1->GetX();
+            float dy = n2->GetY() - n1->GetY();
+            cost = std::sqrt(dx*dx + dy*dy)*(1.0f + (rand() % 100)/100.0f) + 0.01f;
+        }
+        n1->AddNeighbor(n2, cost);
+    }
+    graph.Compile();
+}
+
+
+// Build a grid like the one of the demo, with random costs from 10 to 15
+void BuildRandomGrid(Graph &graph, int cols, int rows){
+
+    graph.BuildGrid(cols, rows, 0.5, 0.5, -4.25, 0.75, 4);
+}
+
+
+// Compare the searches that run on the compact graph with the reference:
+// A* on the heap and on the bucket queue with each heuristic, the
+// bidirectional search, the Contraction Hierarchy, and Graph::FindPath
+// with the settings that select each of them
+bool TestSearches(const char *name, Graph &graph){
+
+    const CsrGraph &csr = graph.GetCompiledGraph();
+    int n = csr.GetNumNodes();
+    SearchContext reference, context;
+    ContractionHierarchy ch;
+    ch.Build(csr);
+    std::vector<int> path;
+    float cost;
+    int checks = 0, failures = 0;
+
+    HeuristicType types[] = {HEURISTIC_ZERO, HEURISTIC_EUCLIDEAN, HEURISTIC_MANHATTAN, HEURISTIC_OCTILE};
+    for (int q = 0; q < num_queries_g; q++) {
+        int start = rand() % n;
+        int end = rand() % n;
+        float expected = ReferenceCost(csr, start, end, reference);
+
+        for (int t = 0; t < 4; t++) {
+            Heuristic heuristic = Heuristic::ForGraph(csr, types[t]);
+
+            // A* on the indexed heap
+            float result = AStar(csr, start, end, heuristic, context.GetHeap(), context) ? context.GetCost(end) : INFINITY;
+            checks++;
+            if (!SameCost(expected, result)) {
+                Fail(failures, "A* on the heap", start, end, expected, result);
+            }
+
+            // A* on the bucket queue, with the estimate rounded down
+            if (csr.HasIntegerCosts(1024)) {
+                BucketQueue &buckets = context.GetBuckets();
+                buckets.SetMaxCost(2*csr.GetMaxCost());
+                result = AStar(csr, start, end, heuristic.Floored(), buckets, context) ? context.GetCost(end) : INFINITY;
+                checks++;
+                if (!SameCost(expected, result)) {
+                    Fail(failures, "A* on the bucket queue", start, end, expected, result);
+                }
+            }
+
+            // Bidirectional search, which joins the path itself
+            result = BidirectionalSearch(csr, start, end, heuristic, context.GetHeap(), context.GetReverse().GetHeap(), context, path, cost) ? cost : INFINITY;
+            checks++;
+            if (!SameCost(expected, result) || (result != INFINITY && !SameCost(result, PathCost(csr, start, end, path)))) {
+                Fail(failures, "bidirectional search", start, end, expected, result);
+            }
+        }
+
+        // Contraction Hierarchy, whose path is unpacked into the edges
+        // of the graph
+        float result = ch.FindPath(start, end, context, path, cost) ? cost : INFINITY;
+        checks++;
+        if (!SameCost(expected, result) || (result != INFINITY && !SameCost(result, PathCost(csr, start, end, path)))) {
+            Fail(failures, "Contraction Hierarchy", start, end, expected, result);
+        }
+    }
+
+    // Graph::FindPath picks the search from the settings of the graph
+    for (int mode = 0; mode < 4; mode++) {
+        graph.SetHeuristic(mode == 0 ? HEURISTIC_ZERO : HEURISTIC_EUCLIDEAN);
+        graph.SetBidirectional(mode == 2);
+        if (mode == 3) {
+            graph.BuildHierarchy();
+        }
+        for (int q = 0; q < num_queries_g/4; q++) {
+            int start = rand() % n;
+            int end = rand() % n;
+            float expected = ReferenceCost(csr, start, end, reference);
+            float result = graph.FindPath(start, end, context, path, &cost) ? cost : INFINITY;
+            checks++;
+            if (!SameCost(expected, result) || (result != INFINITY && !SameCost(result, PathCost(csr, start, end, path)))) {
+                Fail(failures, "Graph::FindPath", start, end, expected, result);
+            }
+        }
+    }
+    graph.SetBidirectional(false);
+
+    return Report(name, checks, failures);
+}
+
+
+// Compare Jump Point Search, with and without the jump table of JPS+, on
+// grids with random walls, 4-connected and 8-connected
+// The reference runs on a graph with the same moves
+bool TestJumpPointSearch(void){
+
+    const int cols = 48, rows = 32;
+    int checks = 0, failures = 0;
+    for (int round = 0; round < 4; round++) {
+        bool diagonal = round % 2 == 1;
+
+        // About a quarter of the cells are walls
+        std::vector<unsigned char> passable(cols*rows);
+        for (int i = 0; i < cols*rows; i++) {
+            passable[i] = rand() % 4 != 0;
+        }
+
+        // Graph with the moves that JPS allows: straight moves between
+        // open cells, and diagonal moves that do not cut a wall
+        Graph graph;
+        for (int i = 0; i < rows; i++) {
+            for (int j = 0; j < cols; j++) {
+                graph.AddNode(i*cols + j, (float) j, (float) -i);
+            }
+        }
+        for (int i = 0; i < rows; i++) {
+            for (int j = 0; j < cols; j++) {
+                int a = i*cols + j;
+                if (!passable[a]) {
+                    continue;
+                }
+                if (j + 1 < cols && passable[a + 1]) {
+                    graph.GetNode(a)->AddNeighbor(graph.GetNode(a + 1), 1.0f);
+                }
+                if (i + 1 < rows && passable[a + cols]) {
+                    graph.GetNode(a)->AddNeighbor(graph.GetNode(a + cols), 1.0f);
+                }
+                if (diagonal && i + 1 < rows && j + 1 < cols && passable[a + 1] && passable[a + cols] && passable[a + cols + 1]) {
+                    graph.GetNode(a)->AddNeighbor(graph.GetNode(a + cols + 1), std::sqrt(2.0f));
+                }
+                if (diagonal && i + 1 < rows && j > 0 && passable[a - 1] && passable[a + cols] && passable[a + cols - 1]) {
+                    graph.GetNode(a)->AddNeighbor(graph.GetNode(a + cols - 1), std::sqrt(2.0f));
+                }
+            }
+        }
+        const CsrGraph &csr = graph.GetCompiledGraph();
+
+        // Set up the searches from the flags, and from the graph
+        JumpPointSearch jps[3];
+        jps[0].Build(cols, rows, passable, diagonal, 1.0f, false);
+        jps[1].Build(cols, rows, passable, diagonal, 1.0f, true);
+        checks++;
+        if (!jps[2].Build(csr, cols, rows, true) || jps[2].IsDiagonal() != diagonal) {
+            std::cout << "  the grid layout of the graph was not recognized" << std::endl;
+            failures++;
+            continue;
+        }
+
+        SearchContext reference, context;
+        std::vector<int> path;
+        float cost;
+        for (int q = 0; q < num_queries_g; q++) {
+            int start = rand() % (cols*rows);
+            int end = rand() % (cols*rows);
+            if (!passable[start] || !passable[end]) {
+                continue;
+            }
+            float expected = ReferenceCost(csr, start, end, reference);
+            for (int k = 0; k < 3; k++) {
+                float result = jps[k].FindPath(start, end, context, path, cost) ? cost : INFINITY;
+                checks++;
+                if (!SameCost(expected, result) || (result != INFINITY && !SameCost(result, PathCost(csr, start, end, path)))) {
+                    Fail(failures, k == 0 ? "JPS" : "JPS+", start, end, expected, result);
+                }
+            }
+        }
+    }
+
+    return Report("jump point search", checks, failures);
+}
+
+
+// Compare the implicit GridGraph with the explicit grid of BuildGrid.
+// GridGraph is a separate type, which Graph does not use, so the same
+// edges are copied into it from the compact graph. The second round
+// leaves out about a fifth of the edges in both, so that some cells
+// cannot be reached
+bool TestGridGraph(void){
+
+    const int cols = 60, rows = 40;
+    int checks = 0, failures = 0;
+    for (int round = 0; round < 2; round++) {
+        Graph full;
+        BuildRandomGrid(full, cols, rows);
+        const CsrGraph &full_csr = full.GetCompiledGraph();
+
+        // Same layout as BuildGrid, whose rows start at the top of the
+        // viewport
+        GridGraph grid;
+        grid.Build(cols, rows, 0.5, 0.5, -4.25, 4 - 0.75);
+        Graph explicit_grid;
+        for (int n = 0; n < cols*rows; n++) {
+            explicit_grid.AddNode(n, full_csr.GetX(n), full_csr.GetY(n));
+        }
+        for (int n = 0; n < cols*rows; n++) {
+            for (uint32_t e = full_csr.EdgeBegin(n); e < full_csr.EdgeEnd(n); e++) {
+                int m = full_csr.GetTarget(e);
+                if (m < n || (round == 1 && rand() % 5 == 0)) {
+                    continue;
+                }
+                grid.Connect(n, m, (int) full_csr.GetCost(e));
+                explicit_grid.GetNode(n)->AddNeighbor(explicit_grid.GetNode(m), full_csr.GetCost(e));
+            }
+        }
+        const CsrGraph &csr = explicit_grid.GetCompiledGraph();
+
+        SearchContext reference, context;
+        std::vector<int> path;
+        float cost;
+        Heuristic heuristic = Heuristic::ForGraph(grid, HEURISTIC_MANHATTAN);
+        for (int q = 0; q < num_queries_g; q++) {
+            int start = rand() % (cols*rows);
+            int end = rand() % (cols*rows);
+            float expected = ReferenceCost(csr, start, end, reference);
+
+            // A* of the grid, and the reference search run on the grid
+            float result = grid.FindPath(start, end, context, path, &cost) ? cost : INFINITY;
+            checks++;
+            if (!SameCost(expected, result) || (result != INFINITY && !SameCost(result, PathCost(csr, start, end, path)))) {
+                Fail(failures, "GridGraph::FindPath", start, end, expected, result);
+            }
+            result = ReferenceCost(grid, start, end, context);
+            checks++;
+            if (!SameCost(expected, result)) {
+                Fail(failures, "Dijkstra on the grid", start, end, expected, result);
+            }
+            result = BidirectionalSearch(grid, start, end, heuristic, context.GetHeap(), context.GetReverse().GetHeap(), context, path, cost) ? cost : INFINITY;
+            checks++;
+            if (!SameCost(expected, result) || (result != INFINITY && !SameCost(result, PathCost(csr, start, end, path)))) {
+                Fail(failures, "bidirectional search on the grid", start, end, expected, result);
+            }
+        }
+    }
+
+    return Report("grid graph", checks, failures);
+}
+
+
+// Repair the path with D* Lite while edge costs change and the start
+// node moves along the path, and compare each repaired path with a new
+// search of the reference
+bool TestDStarLite(const char *name, Graph &graph){
+
+    const CsrGraph &csr = graph.GetCompiledGraph();
+    int n = csr.GetNumNodes();
+    SearchContext reference;
+    int checks = 0, failures = 0;
+
+    // Pick endpoints that are connected, since changing costs never
+    // disconnects them
+    int start, end;
+    do {
+        start = rand() % n;
+        end = rand() % n;
+    } while (start == end || ReferenceCost(csr, start, end, reference) == INFINITY);
+
+    graph.SetIncremental(true);
+    graph.SetStartNode(graph.GetNode(start));
+    graph.SetEndNode(graph.GetNode(end));
+    for (int round = 0; round < 50; round++) {
+        graph.FindPath();
+
+        // The marked nodes are the path, followed by the start and end
+        // nodes
+        std::vector<int> path(graph.GetMarkedNodes().begin(), graph.GetMarkedNodes().end() - 2);
+        float expected = ReferenceCost(csr, start, end, reference);
+        float result = PathCost(csr, start, end, path);
+        checks++;
+        if (!SameCost(expected, result)) {
+            Fail(failures, "D* Lite", start, end, expected, result);
+        }
+
+        // Make some edges on the path more expensive and some random
+        // edges cheaper, so that the path has to move both ways
+        for (size_t i = 1; i < path.size(); i += 3) {
+            graph.SetEdgeCost(path[i-1], path[i], 10.0f + (float) (rand() % 40));
+        }
+        for (int k = 0; k < 5; k++) {
+            int a = rand() % n;
+            if (csr.EdgeBegin(a) < csr.EdgeEnd(a)) {
+                graph.SetEdgeCost(a, csr.GetTarget(csr.EdgeBegin(a)), 1.0f + (float) (rand() % 5));
+            }
+        }
+
+        // Every few rounds, move the start node one step along the path
+        if (round % 5 == 4 && path.size() > 2) {
+            start = path[1];
+            graph.SetStartNode(graph.GetNode(start));
+        }
+    }
+    graph.SetIncremental(false);
+
+    return Report(name, checks, failures);
+}
+
+
+// Compare the costs and paths of many-to-many distance tables, computed
+// with the searches of the compact graph and then on the hierarchy
+bool TestDistanceTable(const char *name, Graph &graph){
+
+    const CsrGraph &csr = graph.GetCompiledGraph();
+    int n = csr.GetNumNodes();
+    SearchContext reference;
+    DistanceTable table(2);
+    int checks = 0, failures = 0;
+
+    const int num_sources = 12, num_targets = 15;
+    int sources[num_sources], targets[num_targets];
+    for (int i = 0; i < num_sources; i++) {
+        sources[i] = rand() % n;
+    }
+    for (int j = 0; j < num_targets; j++) {
+        targets[j] = rand() % n;
+    }
+
+    // A repeated target has to get the same result
+    targets[num_targets - 1] = targets[0];
+
+    for (int hierarchy = 0; hierarchy < 2; hierarchy++) {
+        if (hierarchy == 1) {
+            graph.BuildHierarchy();
+        }
+        std::vector<int> paths[num_sources*num_targets];
+        float costs[num_sources*num_targets];
+        graph.FindDistances(table, sources, num_sources, targets, num_targets, paths, costs);
+        for (int i = 0; i < num_sources; i++) {
+            for (int j = 0; j < num_targets; j++) {
+                int k = i*num_targets + j;
+                float expected = ReferenceCost(csr, sources[i], targets[j], reference);
+                checks++;
+                if (!SameCost(expected, costs[k]) || (costs[k] != INFINITY && !SameCost(costs[k], PathCost(csr, sources[i], targets[j], paths[k])))) {
+                    Fail(failures, hierarchy ? "distance table on the hierarchy" : "distance table", sources[i], targets[j], expected, costs[k]);
+                }
+            }
+        }
+    }
+
+    return Report(name, checks, failures);
+}
+
+
+// Run queries twice with the path cache enabled: the first one misses
+// and the second one hits, and both have to match the reference. After
+// an edge cost changes, the cached routes are stale and searched again
+bool TestPathCache(const char *name, Graph &graph){
+
+    const CsrGraph &csr = graph.GetCompiledGraph();
+    int n = csr.GetNumNodes();
+    SearchContext reference, context;
+    std::vector<int> path;
+    float cost;
+    int checks = 0, failures = 0;
+
+    graph.SetPathCache(1 << 20);
+    for (int round = 0; round < 3; round++) {
+        for (int q = 0; q < num_queries_g/4; q++) {
+            int start = rand() % n;
+            int end = rand() % n;
+            float expected = ReferenceCost(csr, start, end, reference);
+            for (int repeat = 0; repeat < 2; repeat++) {
+                PathCacheStats before = graph.GetPathCacheStats();
+                float result = graph.FindPath(start, end, context, path, &cost) ? cost : INFINITY;
+                PathCacheStats after = graph.GetPathCacheStats();
+                checks++;
+                if (!SameCost(expected, result) || (result != INFINITY && !SameCost(result, PathCost(csr, start, end, path)))) {
+                    Fail(failures, repeat == 0 ? "cache miss" : "cache hit", start, end, expected, result);
+                }
+
+                // Routes can repeat between random queries, so only the
+                // second lookup is known to hit
+                checks++;
+                if (repeat == 1 && after.hits != before.hits + 1) {
+                    Fail(failures, "cache hit count", start, end, (float) (before.hits + 1), (float) after.hits);
+                }
+            }
+        }
+
+        // Change some edge costs, which makes every cached route stale
+        for (int k = 0; k < 20; k++) {
+            int a = rand() % n;
+            if (csr.EdgeBegin(a) < csr.EdgeEnd(a)) {
+                graph.SetEdgeCost(a, csr.GetTarget(csr.EdgeBegin(a)), 1.0f + (float) (rand() % 30));
+            }
+        }
+    }
+    graph.SetPathCache(0);
+
+    return Report(name, checks, failures);
+}
+
+
+int main(void){
+
+    srand(2501);
+    bool ok = true;
+
+    try {
+        // Random graphs with real and with integer costs, where the
+        // latter select the bucket queue
+        {
+            Graph graph;
+            BuildRandomGraph(graph, 1000, 2500, false);
+            ok = TestSearches("random graph", graph) && ok;
+        }
+        {
+            Graph graph;
+            BuildRandomGraph(graph, 1000, 2500, true);
+            ok = TestSearches("random graph with integer costs", graph) && ok;
+        }
+        {
+            Graph graph;
+            BuildRandomGrid(graph, 60, 40);
+            ok = TestSearches("grid", graph) && ok;
+        }
+
+        ok = TestJumpPointSearch() && ok;
+        ok = TestGridGraph() && ok;
+
+        {
+            Graph graph;
+            BuildRandomGraph(graph, 1000, 3000, false);
+            ok = TestDStarLite("D* Lite on a random graph", graph) && ok;
+        }
+        {
+            Graph graph;
+            BuildRandomGrid(graph, 60, 40);
+            ok = TestDStarLite("D* Lite on a grid", graph) && ok;
+        }
+
+        {
+            Graph graph;
+            BuildRandomGraph(graph, 1000, 2500, false);
+            ok = TestDistanceTable("distance table on a random graph", graph) && ok;
+        }
+        {
+            Graph graph;
+            BuildRandomGrid(graph, 60, 40);
+            ok = TestDistanceTable("distance table on a grid", graph) && ok;
+        }
+
+        {
+            Graph graph;
+            BuildRandomGraph(graph, 1000, 2500, false);
+            ok = TestPathCache("path cache on a random graph", graph) && ok;
+        }
+        {
+            Graph graph;
+            BuildRandomGrid(graph, 60, 40);
+            ok = TestPathCache("path cache on a grid", graph) && ok;
+        }
+    }
+    catch (std::exception &e){
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,153 @@
+#ifndef RESUMABLE_SEARCH_H_
+#define RESUMABLE_SEARCH_H_
+
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+#include "search_context.h"
+#include "heuristic.h"
+
+namespace game {
+
+// State of a resumable search
+enum SearchStatus {
+    SEARCH_IDLE, // No search was started
+    SEARCH_RUNNING, // The search needs more steps
+    SEARCH_FOUND, // The end node was reached
+    SEARCH_FAILED // The end node cannot be reached
+};
+
+
+// A* search that runs in small steps, to spread a long search over
+// several frames
+//
+// The open list and all other state stay in the search between calls
+// to Step, which expands nodes until a budget of expansions or time is
+// used up. The search finds the same paths as AStar. The graph type
+// needs to provide the compact-graph interface and node positions, and
+// must not change while the search is running
+template <typename GraphType>
+class ResumableSearch {
+
+    public:
+        // Create a search that is not running
+        ResumableSearch(void) { graph_ = NULL; status_ = SEARCH_IDLE; start_ = -1; end_ = -1; }
+
+        // Start a search for a path between nodes start and end
+        // No node is expanded until Step is called
+        void Start(const GraphType &graph, int start, int end, const Heuristic &heuristic){
+            graph_ = &graph;
+            start_ = start;
+            end_ = end;
+            heuristic_ = heuristic;
+            end_x_ = graph.GetX(end);
+            end_y_ = graph.GetY(end);
+
+            // Reset the search state and the open list
+            QuadHeap &queue = context_.GetHeap();
+            context_.Reset(graph.GetNumNodes());
+            queue.Clear(graph.GetNumNodes());
+
+            // The start node is added to the queue with its estimate
+            context_.SetCost(start, 0.0);
+            queue.Push(start, heuristic_.Estimate(graph.GetX(start), graph.GetY(start), end_x_, end_y_));
+            context_.GetStats().pushes++;
+            status_ = SEARCH_RUNNING;
+        }
+
+        // Expand at most max_expansions nodes if it is positive, and stop
+        // once max_microseconds have passed if it is positive. At least
+        // one node is expanded. Returns the status of the search after
+        // the step
+        SearchStatus Step(int max_expansions, int max_microseconds = 0){
+            if (status_ != SEARCH_RUNNING){
+                return status_;
+            }
+            std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(max_microseconds);
+            const GraphType &graph = *graph_;
+            QuadHeap &queue = context_.GetHeap();
+            SearchStats &stats = context_.GetStats();
+
+            int next_check = 1;
+            for (int i = 0; max_expansions <= 0 || i < max_expansions; i++){
+                // Reading the clock costs more than expanding a node, so
+                // it is read after 1, 2, 4, ... expansions, and then every
+                // 64, which still honors budgets of a few microseconds
+                if (max_microseconds > 0 && i == next_check){
+                    if (std::chrono::steady_clock::now() >= deadline){
+                        break;
+                    }
+                    next_check = next_check < 64 ? 2*next_check : next_check + 64;
+                }
+                if (queue.Empty()){
+                    status_ = SEARCH_FAILED;
+                    break;
+                }
+
+                // Remove the node with the lowest estimated total cost
+                // The indexed heap holds no stale entries
+                int node;
+                float key;
+                queue.Pop(node, key);
+                stats.pops++;
+                context_.SetVisited(node, true);
+                stats.expanded++;
+
+                // If the current node is the end node, we are done
+                if (node == end_){
+                    status_ = SEARCH_FOUND;
+                    break;
+                }
+
+                // Otherwise, relax the edges to the neighbors of the node
+                float cost = context_.GetCost(node);
+                uint32_t edge_end = graph.EdgeEnd(node);
+                for (uint32_t e = graph.EdgeBegin(node); e < edge_end; e++){
+                    int n = graph.GetTarget(e);
+                    float node_cost = cost + graph.GetCost(e);
+                    if (node_cost < context_.GetCost(n)){
+                        context_.SetCost(n, node_cost);
+                        context_.SetPrev(n, node);
+                        queue.Push(n, node_cost + heuristic_.Estimate(graph.GetX(n), graph.GetY(n), end_x_, end_y_));
+                        stats.pushes++;
+                    }
+                }
+            }
+            return status_;
+        }
+
+        // Stop the search, so that it is no longer running
+        inline void Cancel(void) { status_ = SEARCH_IDLE; }
+
+        // Getters
+        inline SearchStatus GetStatus(void) const { return status_; }
+        inline bool IsRunning(void) const { return status_ == SEARCH_RUNNING; }
+        inline int GetStart(void) const { return start_; }
+        inline int GetEnd(void) const { return end_; }
+        inline const SearchStats &GetStats(void) const { return context_.GetStats(); }
+
+        // Get the path and its cost once the search has found it
+        inline void GetPath(std::vector<int> &path) const { context_.GetPath(end_, path); }
+        inline float GetCost(void) const { return context_.GetCost(end_); }
+
+    private:
+        // Graph being searched
+        const GraphType *graph_;
+
+        // Query and its distance estimate
+        int start_, end_;
+        Heuristic heuristic_;
+        float end_x_, end_y_;
+
+        // Current state
+        SearchStatus status_;
+
+        // Search state and open list, kept between steps
+        SearchContext context_;
+};
+
+} // namespace game
+
+#endif // RESUMABLE_SEARCH_H_
@@ -0,0 +1,54 @@
+#include <algorithm>
+
+#include "search_context.h"
+
+namespace game {
+
+SearchContext::SearchContext(void){
+
+    // The array is sized by Reset() before a search
+    generation_ = 0;
+    stats_ = SearchStats();
+}
+
+
+void SearchContext::Reset(int num_nodes){
+
+    // Move on to a new generation, which invalidates all the entries
+    // written by earlier searches
+    generation_++;
+    stats_ = SearchStats();
+
+    // Clear the stamps explicitly if the array changes size, or if the
+    // counter wrapped around and old stamps could match again
+    if ((size_t) num_nodes != state_.size() || generation_ == 0){
+        NodeState unreached = {0, (float) INT_MAX, -1, false};
+        state_.assign(num_nodes, unreached);
+        generation_ = 1;
+    }
+}
+
+
+
+SearchContext &SearchContext::GetReverse(void){
+
+    if (!reverse_){
+        reverse_.reset(new SearchContext());
+    }
+    return *reverse_;
+}
+
+
+void SearchContext::GetPath(int end, std::vector<int> &path) const {
+
+    // Go in reverse from the end to the start of the search
+    path.clear();
+    for (int current = end; current != -1; current = GetPrev(current)) {
+        path.push_back(current);
+    }
+
+    // Reverse path to get the order from start to end
+    std::reverse(path.begin(), path.end());
+}
+
+} // namespace game
@@ -0,0 +1,118 @@
+#ifndef SEARCH_CONTEXT_H_
+#define SEARCH_CONTEXT_H_
+
+#include <vector>
+#include <memory>
+#include <climits>
+
+#include "search_queue.h"
+
+namespace game {
+
+// Counters describing the work done by a search
+struct SearchStats {
+    long pushes; // Nodes inserted into the queue, or whose key was lowered
+    long pops; // Entries removed from the queue
+    long stale_pops; // Removed entries of nodes that were already expanded
+    long expanded; // Nodes whose edges were relaxed
+};
+
+// Per-query state of a path search
+//
+// The state is kept in a dense array indexed by node, separate from
+// the graph itself, so that several searches can run at the same time
+// on one shared graph as long as each uses its own context
+//
+// Resetting the context does not touch the array. Instead, each entry
+// is stamped with the search generation in which it was last written,
+// and entries with an older stamp read as unreached. A query therefore
+// only costs time proportional to the nodes it actually visits
+class SearchContext {
+
+    public:
+        // Create an empty context
+        SearchContext(void);
+
+        // Prepare the context for a search on a graph with the given
+        // number of nodes: all costs read as infinity, all links to
+        // previous nodes are cleared, and no node is visited
+        //
+        // This takes constant time unless the number of nodes changed
+        // or the generation counter wrapped around
+        void Reset(int num_nodes);
+
+        // Get the number of nodes the context was prepared for
+        inline int GetNumNodes(void) const { return state_.size(); }
+
+        // Get the node indices on the path found to node end, in order
+        // from the start of the search to end
+        void GetPath(int end, std::vector<int> &path) const;
+
+        // Get the statistics of the current search
+        inline SearchStats &GetStats(void) { return stats_; }
+        inline const SearchStats &GetStats(void) const { return stats_; }
+
+        // Get a second context for the backward half of bidirectional
+        // searches, which is created the first time it is needed
+        SearchContext &GetReverse(void);
+
+        // Get the priority queues used by searches with this context
+        inline QuadHeap &GetHeap(void) { return heap_; }
+        inline BucketQueue &GetBuckets(void) { return buckets_; }
+
+        // Check whether node n was written during the current search
+        inline bool IsReached(int n) const { return state_[n].stamp == generation_; }
+
+        // Getters for the state of node n
+        inline float GetCost(int n) const { return IsReached(n) ? state_[n].cost : INT_MAX; }
+        inline int GetPrev(int n) const { return IsReached(n) ? state_[n].prev : -1; }
+        inline bool IsVisited(int n) const { return IsReached(n) && state_[n].visited; }
+
+        // Setters for the state of node n
+        inline void SetCost(int n, float cost) { Touch(n).cost = cost; }
+        inline void SetPrev(int n, int prev) { Touch(n).prev = prev; }
+        inline void SetVisited(int n, bool visited) { Touch(n).visited = visited; }
+
+    private:
+        // State of one node, kept together so that a search touches a
+        // single cache line per node
+        struct NodeState {
+            unsigned int stamp; // Generation in which the entry was written
+            float cost; // Cost of the best path found so far
+            int prev; // Index of the previous node on the best path, or -1
+            bool visited; // Flag indicating that the node was expanded
+        };
+
+        // Array with the state of each node
+        std::vector<NodeState> state_;
+
+        // Generation of the current search
+        unsigned int generation_;
+
+        // Statistics of the current search
+        SearchStats stats_;
+
+        // Priority queues, kept here so that their memory is reused
+        QuadHeap heap_;
+        BucketQueue buckets_;
+
+        // Context for the backward half of bidirectional searches
+        std::unique_ptr<SearchContext> reverse_;
+
+        // Return the entry of node n, clearing it first if it is left
+        // over from an older search
+        inline NodeState &Touch(int n) {
+            NodeState &s = state_[n];
+            if (s.stamp != generation_){
+                s.stamp = generation_;
+                s.cost = INT_MAX;
+                s.prev = -1;
+                s.visited = false;
+            }
+            return s;
+        }
+};
+
+} // namespace game
+
+#endif // SEARCH_CONTEXT_H_
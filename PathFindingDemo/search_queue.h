@@ -0,0 +1,253 @@
+#ifndef SEARCH_QUEUE_H_
+#define SEARCH_QUEUE_H_
+
+#include <vector>
+
+namespace game {
+
+// Priority queues used by the path searches
+//
+// Each queue policy provides the same interface, so that a search can
+// be instantiated with any of them:
+//
+//     void Clear(int num_nodes)     Empty the queue for a graph with the
+//                                   given number of nodes
+//     bool Empty(void) const        Check if there are nodes left
+//     bool Push(int node, float key)
+//                                   Insert a node, or lower its key if
+//                                   the policy supports it; returns
+//                                   false if an existing entry was updated
+//     void Pop(int &node, float &key)
+//                                   Remove the node with lowest key
+//
+// The heaps can also return the lowest key without removing it with
+// float PeekKey(void) const
+
+
+// D-ary heap that knows the position of each node, so that the key of a
+// node can be decreased in place instead of inserting a duplicate
+//
+// The heap never holds more than one entry per node and never returns
+// stale entries. A larger arity makes the tree shallower, which speeds
+// up decrease-key, and keeps the children of a node in one cache line.
+// The keys are floats for the searches, but any type ordered by
+// operator< can be used, such as the lexicographic keys of D* Lite
+template <int D, typename KeyType = float>
+class IndexedHeap {
+
+    public:
+        IndexedHeap(void) {}
+
+        // Empty the heap, only visiting the entries still in it unless
+        // the number of nodes changed
+        void Clear(int num_nodes){
+            if (pos_.size() != (size_t) num_nodes){
+                pos_.assign(num_nodes, -1);
+            } else {
+                for (size_t i = 0; i < heap_.size(); i++){
+                    pos_[heap_[i].node] = -1;
+                }
+            }
+            heap_.clear();
+        }
+
+        inline bool Empty(void) const { return heap_.empty(); }
+        inline int GetSize(void) const { return heap_.size(); }
+        inline bool Contains(int node) const { return pos_[node] != -1; }
+        inline const KeyType &PeekKey(void) const { return heap_[0].key; }
+        inline int PeekNode(void) const { return heap_[0].node; }
+
+        // Insert a node, or decrease its key if it is already in the heap
+        bool Push(int node, const KeyType &key){
+            int i = pos_[node];
+            if (i == -1){
+                Entry e = {key, node};
+                heap_.push_back(e);
+                SiftUp(heap_.size() - 1);
+                return true;
+            }
+            if (key < heap_[i].key){
+                heap_[i].key = key;
+                SiftUp(i);
+            }
+            return false;
+        }
+
+        // Change the key of a node in the heap, up or down
+        void Update(int node, const KeyType &key){
+            int i = pos_[node];
+            bool lower = key < heap_[i].key;
+            heap_[i].key = key;
+            if (lower){
+                SiftUp(i);
+            } else {
+                SiftDown(i);
+            }
+        }
+
+        // Remove the node with the lowest key
+        void Pop(int &node, KeyType &key){
+            node = heap_[0].node;
+            key = heap_[0].key;
+            Remove(node);
+        }
+
+        // Remove a node from the heap
+        void Remove(int node){
+            int i = pos_[node];
+            pos_[node] = -1;
+
+            // Move the last entry to the hole and restore the heap order,
+            // in whichever direction the entry has to go
+            Entry last = heap_.back();
+            heap_.pop_back();
+            if (i < (int) heap_.size()){
+                heap_[i] = last;
+                pos_[last.node] = i;
+                if (i > 0 && last.key < heap_[(i - 1) / D].key){
+                    SiftUp(i);
+                } else {
+                    SiftDown(i);
+                }
+            }
+        }
+
+    private:
+        // Entry of the heap
+        struct Entry {
+            KeyType key; // Priority of the node, lowest comes first
+            int node; // Index of the node in the graph
+        };
+
+        // Entries in heap order: the children of entry i are the
+        // entries D*i+1 to D*i+D
+        std::vector<Entry> heap_;
+
+        // Position of each node in heap_, or -1 if not in the heap
+        std::vector<int> pos_;
+
+        // Move the entry at position i up until its parent is smaller
+        void SiftUp(int i){
+            Entry e = heap_[i];
+            while (i > 0){
+                int parent = (i - 1) / D;
+                if (!(e.key < heap_[parent].key)){
+                    break;
+                }
+                heap_[i] = heap_[parent];
+                pos_[heap_[i].node] = i;
+                i = parent;
+            }
+            heap_[i] = e;
+            pos_[e.node] = i;
+        }
+
+        // Move the entry at position i down until its children are larger
+        void SiftDown(int i){
+            Entry e = heap_[i];
+            int size = heap_.size();
+            while (true){
+                int first = D*i + 1;
+                if (first >= size){
+                    break;
+                }
+
+                // Find the smallest child
+                int last = first + D < size ? first + D : size;
+                int best = first;
+                for (int c = first + 1; c < last; c++){
+                    if (heap_[c].key < heap_[best].key){
+                        best = c;
+                    }
+                }
+                if (!(heap_[best].key < e.key)){
+                    break;
+                }
+                heap_[i] = heap_[best];
+                pos_[heap_[i].node] = i;
+                i = best;
+            }
+            heap_[i] = e;
+            pos_[e.node] = i;
+        }
+};
+
+
+// Default queue used by the searches
+typedef IndexedHeap<4> QuadHeap;
+
+
+// Dial's bucket queue for searches where all keys are integers
+//
+// Keys must be popped in non-decreasing order and never exceed the key
+// of the last popped node by more than a bound C, which holds for
+// Dijkstra's algorithm on integer edge costs with C the maximum edge
+// cost. For A* with a consistent integer estimate, the estimate changes
+// by at most the cost of an edge, so C is twice the maximum edge cost.
+// The queue then only needs C+1 buckets used in a circular way, and
+// each operation takes constant amortized time. Improving the key of a
+// node inserts a duplicate "zombie" entry that the search has to skip
+class BucketQueue {
+
+    public:
+        BucketQueue(void) { size_ = 0; current_ = -1; }
+
+        // Set the bound C on the keys, which determines the number of
+        // buckets
+        void SetMaxCost(int max_cost){
+            if (bucket_.size() != (size_t) max_cost + 1){
+                bucket_.assign(max_cost + 1, std::vector<int>());
+            }
+        }
+
+        // Empty the queue, keeping the memory of the buckets
+        void Clear(int /* num_nodes */){
+            for (size_t i = 0; i < bucket_.size(); i++){
+                bucket_[i].clear();
+            }
+            size_ = 0;
+            current_ = -1;
+        }
+
+        inline bool Empty(void) const { return size_ == 0; }
+
+        // Insert a node in the bucket of its key
+        // The key is truncated to an integer
+        inline bool Push(int node, float key){
+            long k = (long) key;
+            if (current_ < 0){
+                current_ = k;
+            }
+            bucket_[k % bucket_.size()].push_back(node);
+            size_++;
+            return true;
+        }
+
+        // Remove a node from the lowest non-empty bucket
+        inline void Pop(int &node, float &key){
+            while (bucket_[current_ % bucket_.size()].empty()){
+                current_++;
+            }
+            std::vector<int> &b = bucket_[current_ % bucket_.size()];
+            node = b.back();
+            key = current_;
+            b.pop_back();
+            size_--;
+        }
+
+    private:
+        // Circular array of buckets, bucket k % (C+1) holds the nodes
+        // with key k
+        std::vector<std::vector<int> > bucket_;
+
+        // Number of entries in all buckets
+        int size_;
+
+        // Key of the bucket the next pop starts looking at, which is the
+        // key of the last popped node, or -1 before the first push
+        long current_;
+};
+
+} // namespace game
+
+#endif // SEARCH_QUEUE_H_
@@ -3,6 +3,7 @@
 #include <glm/gtc/type_ptr.hpp>
 
 #include "file_utils.h"
+#include "gl_state.h"
 #include "shader.h"
 
 namespace game {
@@ -73,48 +74,151 @@ void Shader::Init(const char *vertPath, const char *fragPath)
     // and linked
     glDeleteShader(vs);
     glDeleteShader(fs);
+
+    // Read the per-frame constants from the shared uniform buffer
+    GLuint frame_block = glGetUniformBlockIndex(shader_program_, "FrameData");
+    if (frame_block != GL_INVALID_INDEX) {
+        glUniformBlockBinding(shader_program_, frame_block, frame_data_binding_g);
+    }
+
+    // Look up all locations now, so that setting a uniform never needs
+    // a string lookup in the driver
+    CacheLocations();
+}
+
+
+void Shader::CacheLocations(void)
+{
+
+    uniform_.clear();
+    attrib_.clear();
+    GLchar name[256];
+    GLsizei length;
+    GLint size;
+    GLenum type;
+
+    // Uniforms in blocks have no location and are skipped
+    // Arrays are listed as "name[0]", and are also found by "name"
+    GLint count;
+    glGetProgramiv(shader_program_, GL_ACTIVE_UNIFORMS, &count);
+    for (int i = 0; i < count; i++) {
+        glGetActiveUniform(shader_program_, i, sizeof(name), &length, &size, &type, name);
+        GLint location = glGetUniformLocation(shader_program_, name);
+        if (location == -1) {
+            continue;
+        }
+        std::string uniform(name, length);
+        uniform_[uniform] = location;
+        if (uniform.size() > 3 && uniform.compare(uniform.size() - 3, 3, "[0]") == 0) {
+            uniform_[uniform.substr(0, uniform.size() - 3)] = location;
+        }
+    }
+
+    glGetProgramiv(shader_program_, GL_ACTIVE_ATTRIBUTES, &count);
+    for (int i = 0; i < count; i++) {
+        glGetActiveAttrib(shader_program_, i, sizeof(name), &length, &size, &type, name);
+        attrib_[std::string(name, length)] = glGetAttribLocation(shader_program_, name);
+    }
+}
+
+
+GLint Shader::GetUniformLocation(const GLchar *name) const
+{
+
+    std::unordered_map<std::string, GLint>::const_iterator it = uniform_.find(name);
+    return it != uniform_.end() ? it->second : -1;
+}
+
+
+GLint Shader::GetAttribLocation(const GLchar *name) const
+{
+
+    std::unordered_map<std::string, GLint>::const_iterator it = attrib_.find(name);
+    return it != attrib_.end() ? it->second : -1;
 }
 
 
 void Shader::SetUniform1i(const GLchar *name, int value)
 {
 
-    glUniform1i(glGetUniformLocation(shader_program_, name), value);
+    glUniform1i(GetUniformLocation(name), value);
 }
 
 
 void Shader::SetUniform1f(const GLchar *name, float value)
 {
 
-    glUniform1f(glGetUniformLocation(shader_program_, name), value);
+    glUniform1f(GetUniformLocation(name), value);
 }
 
 
 void Shader::SetUniform2f(const GLchar *name, const glm::vec2 &vector)
 {
 
-    glUniform2f(glGetUniformLocation(shader_program_, name), vector.x, vector.y);
+    glUniform2f(GetUniformLocation(name), vector.x, vector.y);
 }
 
 
 void Shader::SetUniform3f(const GLchar *name, const glm::vec3 &vector)
 {
 
-    glUniform3f(glGetUniformLocation(shader_program_, name), vector.x, vector.y, vector.z);
+    glUniform3f(GetUniformLocation(name), vector.x, vector.y, vector.z);
 }
 
 
 void Shader::SetUniform4f(const GLchar *name, const glm::vec4 &vector)
 {
 
-    glUniform4f(glGetUniformLocation(shader_program_, name), vector.x, vector.y, vector.z, vector.w);
+    glUniform4f(GetUniformLocation(name), vector.x, vector.y, vector.z, vector.w);
 }
 
 
 void Shader::SetUniformMat4(const GLchar *name, const glm::mat4 &matrix)
 {
 
-    glUniformMatrix4fv(glGetUniformLocation(shader_program_, name), 1, GL_FALSE, glm::value_ptr(matrix));
+    glUniformMatrix4fv(GetUniformLocation(name), 1, GL_FALSE, glm::value_ptr(matrix));
+}
+
+
+void Shader::SetUniform1i(GLint location, int value)
+{
+
+    glUniform1i(location, value);
+}
+
+
+void Shader::SetUniform1f(GLint location, float value)
+{
+
+    glUniform1f(location, value);
+}
+
+
+void Shader::SetUniform2f(GLint location, const glm::vec2 &vector)
+{
+
+    glUniform2f(location, vector.x, vector.y);
+}
+
+
+void Shader::SetUniform3f(GLint location, const glm::vec3 &vector)
+{
+
+    glUniform3f(location, vector.x, vector.y, vector.z);
+}
+
+
+void Shader::SetUniform4f(GLint location, const glm::vec4 &vector)
+{
+
+    glUniform4f(location, vector.x, vector.y, vector.z, vector.w);
+}
+
+
+void Shader::SetUniformMat4(GLint location, const glm::mat4 &matrix)
+{
+
+    glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(matrix));
 }
 
 
@@ -128,14 +232,14 @@ Shader::~Shader()
 void Shader::Enable() 
 {
 
-    glUseProgram(shader_program_);
+    GLState::UseProgram(shader_program_);
 }
 
 
 void Shader::Disable()
 {
 
-    glUseProgram(0);
+    GLState::UseProgram(0);
 }
 
 } // namespace game
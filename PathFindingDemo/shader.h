@@ -4,9 +4,15 @@
 #define GLEW_STATIC
 #include <GL/glew.h>
 #include <glm/glm.hpp>
+#include <string>
+#include <unordered_map>
 
 namespace game {
 
+    // Binding point of the FrameData uniform block, which holds the
+    // constants shared by all shaders during a frame
+    const GLuint frame_data_binding_g = 0;
+
     // A class that stores a pair of vertex, fragment shaders
     class Shader {
 
@@ -15,12 +21,23 @@ namespace game {
             ~Shader();
 
             // Initialize shader with source files
+            // The locations of all uniforms and attributes are looked up
+            // once here, and the FrameData block, if any, is bound to
+            // frame_data_binding_g
             void Init(const char *vertPath, const char *fragPath);
 
             // Enable or disable this specific shader
             void Enable();
             void Disable();
 
+            // Get the location of a uniform or attribute variable, or -1
+            // if the shader does not use it
+            GLint GetUniformLocation(const GLchar *name) const;
+            GLint GetAttribLocation(const GLchar *name) const;
+
+            // The setters below take the name of a uniform, or its
+            // location to also save the lookup in the cache
+
             // Sets a uniform integer variable in your shader program to a value
             void SetUniform1i(const GLchar *name, int value);
 
@@ -39,6 +56,14 @@ namespace game {
             // Sets a uniform matrix4x4 variable in your shader program to a matrix4x4
             void SetUniformMat4(const GLchar *name, const glm::mat4 &matrix);
 
+            // Same setters with a location
+            void SetUniform1i(GLint location, int value);
+            void SetUniform1f(GLint location, float value);
+            void SetUniform2f(GLint location, const glm::vec2 &vector);
+            void SetUniform3f(GLint location, const glm::vec3 &vector);
+            void SetUniform4f(GLint location, const glm::vec4 &vector);
+            void SetUniformMat4(GLint location, const glm::mat4 &matrix);
+
             // Get OpenGL reference of shader program
             inline GLuint GetShaderProgram(void) const { return shader_program_; }
 
@@ -46,6 +71,13 @@ namespace game {
             // Reference to shader program
             GLuint shader_program_;
 
+            // Locations of the active uniform and attribute variables
+            std::unordered_map<std::string, GLint> uniform_;
+            std::unordered_map<std::string, GLint> attrib_;
+
+            // Fill the location caches from the linked program
+            void CacheLocations(void);
+
     }; // class Shader
 } // namespace game
 
@@ -0,0 +1,105 @@
+#ifndef SHORTEST_PATH_TREE_H_
+#define SHORTEST_PATH_TREE_H_
+
+#include <vector>
+#include <cstdint>
+
+#include "search_context.h"
+
+namespace game {
+
+// Shortest paths from one source node to any target, grown on demand
+//
+// This is Dijkstra's algorithm without an end node: the search is
+// suspended as soon as the requested target is settled, and resumed
+// from the same queue for a target that is not settled yet. Paths to
+// settled targets are read from the tree without any search, so
+// repeated queries from the same source only cost the length of the
+// path. The graph type needs to provide the compact-graph interface,
+// and must not change while the tree is used
+template <typename GraphType>
+class ShortestPathTree {
+
+    public:
+        // Create a tree that is not rooted anywhere
+        ShortestPathTree(void) { graph_ = NULL; source_ = -1; }
+
+        // Start a new tree from the source node
+        void Start(const GraphType &graph, int source){
+            graph_ = &graph;
+            source_ = source;
+            context_.Reset(graph.GetNumNodes());
+            context_.GetHeap().Clear(graph.GetNumNodes());
+            context_.SetCost(source, 0.0);
+            context_.GetHeap().Push(source, 0.0);
+            context_.GetStats().pushes++;
+        }
+
+        // Drop the tree, for example after the graph changed
+        inline void Clear(void) { graph_ = NULL; source_ = -1; }
+
+        // Check if the tree grows from the given source node
+        inline bool IsRootedAt(int source) const { return graph_ != NULL && source_ == source; }
+
+        // Check if the shortest path to node n is known
+        inline bool IsSettled(int n) const { return graph_ != NULL && context_.IsVisited(n); }
+
+        // Grow the tree until the target node is settled
+        // Returns false if the target cannot be reached
+        bool Settle(int target){
+            if (IsSettled(target)){
+                return true;
+            }
+            const GraphType &graph = *graph_;
+            QuadHeap &queue = context_.GetHeap();
+            SearchStats &stats = context_.GetStats();
+            while (!queue.Empty()){
+                // The indexed heap holds no stale entries
+                int node;
+                float cost;
+                queue.Pop(node, cost);
+                stats.pops++;
+                context_.SetVisited(node, true);
+                stats.expanded++;
+
+                // Relax the edges before stopping, so that the search
+                // can be resumed from the queue as it is
+                uint32_t edge_end = graph.EdgeEnd(node);
+                for (uint32_t e = graph.EdgeBegin(node); e < edge_end; e++){
+                    int n = graph.GetTarget(e);
+                    float node_cost = cost + graph.GetCost(e);
+                    if (node_cost < context_.GetCost(n)){
+                        context_.SetCost(n, node_cost);
+                        context_.SetPrev(n, node);
+                        queue.Push(n, node_cost);
+                        stats.pushes++;
+                    }
+                }
+                if (node == target){
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // Get the path from the source to a settled target, and its cost
+        inline void GetPath(int target, std::vector<int> &path) const { context_.GetPath(target, path); }
+        inline float GetCost(int target) const { return context_.GetCost(target); }
+
+        // Get the statistics of the tree since it was started
+        inline const SearchStats &GetStats(void) const { return context_.GetStats(); }
+
+    private:
+        // Graph the tree grows on, or NULL if not started
+        const GraphType *graph_;
+
+        // Root of the tree
+        int source_;
+
+        // Costs, links and queue of the suspended search
+        SearchContext context_;
+};
+
+} // namespace game
+
+#endif // SHORTEST_PATH_TREE_H_
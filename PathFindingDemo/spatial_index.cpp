@@ -0,0 +1,215 @@
+#include <algorithm>
+#include <cmath>
+
+#include "spatial_index.h"
+
+namespace game {
+
+SpatialIndex::SpatialIndex(void){
+
+    size_ = 0;
+    cell_size_ = 1.0f;
+    rebuild_size_ = 1;
+}
+
+
+void SpatialIndex::Clear(void){
+
+    x_.clear();
+    y_.clear();
+    used_.clear();
+    next_.clear();
+    head_.clear();
+    size_ = 0;
+    cell_size_ = 1.0f;
+    rebuild_size_ = 1;
+}
+
+
+void SpatialIndex::Insert(int item, float x, float y){
+
+    if (item < (int) used_.size() && used_[item]){
+        Move(item, x, y);
+        return;
+    }
+
+    // Make room for the identifier
+    if (item >= (int) used_.size()){
+        x_.resize(item + 1, 0.0f);
+        y_.resize(item + 1, 0.0f);
+        used_.resize(item + 1, 0);
+        next_.resize(item + 1, -1);
+    }
+    x_[item] = x;
+    y_[item] = y;
+    used_[item] = 1;
+    size_++;
+
+    // Adapt the cells to the new density once there are twice as many
+    // points as at the last rebuild
+    if (size_ >= rebuild_size_){
+        Rebuild();
+    } else {
+        Link(item);
+    }
+}
+
+
+void SpatialIndex::Move(int item, float x, float y){
+
+    if (item >= (int) used_.size() || !used_[item]){
+        Insert(item, x, y);
+        return;
+    }
+
+    // Only change the lists if the point leaves its cell
+    if (Cell(x) != Cell(x_[item]) || Cell(y) != Cell(y_[item])){
+        Unlink(item);
+        x_[item] = x;
+        y_[item] = y;
+        Link(item);
+    } else {
+        x_[item] = x;
+        y_[item] = y;
+    }
+}
+
+
+int SpatialIndex::FindNearest(float x, float y, float radius) const {
+
+    int best = -1;
+    float best_d2 = radius*radius;
+    Visit(x - radius, y - radius, x + radius, y + radius, [&](int i){
+        float dx = x_[i] - x;
+        float dy = y_[i] - y;
+        float d2 = dx*dx + dy*dy;
+        // Break ties by identifier, so that the result does not depend
+        // on the order of the lists
+        if (d2 < best_d2 || (d2 == best_d2 && best != -1 && i < best)){
+            best = i;
+            best_d2 = d2;
+        }
+    });
+    return best;
+}
+
+
+void SpatialIndex::FindInRadius(float x, float y, float radius, std::vector<int> &result) const {
+
+    result.clear();
+    float r2 = radius*radius;
+    Visit(x - radius, y - radius, x + radius, y + radius, [&](int i){
+        float dx = x_[i] - x;
+        float dy = y_[i] - y;
+        if (dx*dx + dy*dy < r2){
+            result.push_back(i);
+        }
+    });
+    std::sort(result.begin(), result.end());
+}
+
+
+void SpatialIndex::FindInRect(float min_x, float min_y, float max_x, float max_y, std::vector<int> &result) const {
+
+    result.clear();
+    Visit(min_x, min_y, max_x, max_y, [&](int i){
+        if (x_[i] >= min_x && x_[i] <= max_x && y_[i] >= min_y && y_[i] <= max_y){
+            result.push_back(i);
+        }
+    });
+    std::sort(result.begin(), result.end());
+}
+
+
+int32_t SpatialIndex::Clamp(float v){
+
+    // Positions far away share the border cells, which keeps the
+    // coordinates valid without affecting the results
+    float c = std::floor(v);
+    if (c != c){
+        return 0;
+    }
+    if (c < -2147483648.0f){
+        return INT32_MIN;
+    }
+    if (c >= 2147483648.0f){
+        return INT32_MAX;
+    }
+    return (int32_t) c;
+}
+
+
+void SpatialIndex::Link(int item){
+
+    uint64_t key = Key(Cell(x_[item]), Cell(y_[item]));
+    std::unordered_map<uint64_t, int>::iterator it = head_.find(key);
+    if (it == head_.end()){
+        next_[item] = -1;
+        head_[key] = item;
+    } else {
+        next_[item] = it->second;
+        it->second = item;
+    }
+}
+
+
+void SpatialIndex::Unlink(int item){
+
+    std::unordered_map<uint64_t, int>::iterator it = head_.find(Key(Cell(x_[item]), Cell(y_[item])));
+    if (it->second == item){
+        // Drop the cell once it is empty
+        if (next_[item] == -1){
+            head_.erase(it);
+        } else {
+            it->second = next_[item];
+        }
+    } else {
+        int prev = it->second;
+        while (next_[prev] != item){
+            prev = next_[prev];
+        }
+        next_[prev] = next_[item];
+    }
+    next_[item] = -1;
+}
+
+
+void SpatialIndex::Rebuild(void){
+
+    // Find the bounds of the points
+    float min_x = INFINITY, min_y = INFINITY;
+    float max_x = -INFINITY, max_y = -INFINITY;
+    for (int i = 0; i < (int) used_.size(); i++){
+        if (used_[i]){
+            min_x = std::min(min_x, x_[i]);
+            min_y = std::min(min_y, y_[i]);
+            max_x = std::max(max_x, x_[i]);
+            max_y = std::max(max_y, y_[i]);
+        }
+    }
+
+    // Give each cell the area of one point on average. Points on a line
+    // are spread along its length instead, and a single position gets
+    // an arbitrary size
+    float w = max_x - min_x;
+    float h = max_y - min_y;
+    cell_size_ = std::sqrt(w*h/size_);
+    if (!(cell_size_ > 0.0f) || std::isinf(cell_size_)){
+        cell_size_ = std::max(w, h)/size_;
+    }
+    if (!(cell_size_ > 0.0f) || std::isinf(cell_size_)){
+        cell_size_ = 1.0f;
+    }
+
+    // Place the points in the new cells
+    head_.clear();
+    head_.reserve(size_);
+    for (int i = 0; i < (int) used_.size(); i++){
+        if (used_[i]){
+            Link(i);
+        }
+    }
+    rebuild_size_ = 2*size_;
+}
+
+} // namespace game
@@ -0,0 +1,123 @@
+#ifndef SPATIAL_INDEX_H_
+#define SPATIAL_INDEX_H_
+
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+namespace game {
+
+// Uniform grid over 2D points, for finding the points near a position
+// without checking all of them
+//
+// Each point is identified by a small non-negative integer, such as the
+// index of a node. The points of a cell are kept in a linked list, and
+// only the cells that hold points are stored, so the grid needs no
+// bounds. The cell size follows the density of the points: the grid is
+// rebuilt whenever the number of points doubles, which keeps about one
+// point per cell and costs amortized constant time per insertion
+class SpatialIndex {
+
+    public:
+        // Create an empty index
+        SpatialIndex(void);
+
+        // Remove all the points
+        void Clear(void);
+
+        // Add the point with the given identifier at position (x, y)
+        void Insert(int item, float x, float y);
+
+        // Move an existing point to position (x, y)
+        void Move(int item, float x, float y);
+
+        // Get the number of points
+        inline int GetSize(void) const { return size_; }
+
+        // Find the point closest to (x, y) that is closer than radius
+        // Returns its identifier, or -1 if there is none
+        int FindNearest(float x, float y, float radius) const;
+
+        // Store in result the identifiers of the points closer than
+        // radius to (x, y), in increasing order
+        void FindInRadius(float x, float y, float radius, std::vector<int> &result) const;
+
+        // Store in result the identifiers of the points inside the
+        // rectangle, borders included, in increasing order
+        void FindInRect(float min_x, float min_y, float max_x, float max_y, std::vector<int> &result) const;
+
+    private:
+        // Position of each point, and flag indicating that the
+        // identifier is in use
+        std::vector<float> x_, y_;
+        std::vector<unsigned char> used_;
+        int size_;
+
+        // First point of each occupied cell, and the next point in the
+        // same cell for each point, or -1
+        std::unordered_map<uint64_t, int> head_;
+        std::vector<int> next_;
+
+        // Side of a cell, and the number of points at which the grid is
+        // rebuilt with a new size
+        float cell_size_;
+        int rebuild_size_;
+
+        // Get the cell coordinate of a position along one axis
+        inline int32_t Cell(float v) const { return Clamp(v / cell_size_); }
+        static int32_t Clamp(float v);
+
+        // Combine the cell coordinates into a key
+        static inline uint64_t Key(int32_t cx, int32_t cy) { return ((uint64_t) (uint32_t) cx << 32) | (uint32_t) cy; }
+
+        // Add a point to the list of its cell, or remove it
+        void Link(int item);
+        void Unlink(int item);
+
+        // Choose the cell size for the current points and place them
+        // in the new cells
+        void Rebuild(void);
+
+        // Call visit(item) for every point in the cells overlapping the
+        // rectangle. Scans all the points instead if the rectangle
+        // covers more cells than there are occupied ones
+        template <typename Visitor>
+        void Visit(float min_x, float min_y, float max_x, float max_y, Visitor visit) const;
+};
+
+
+template <typename Visitor>
+void SpatialIndex::Visit(float min_x, float min_y, float max_x, float max_y, Visitor visit) const {
+
+    if (size_ == 0 || !(min_x <= max_x) || !(min_y <= max_y)){
+        return;
+    }
+
+    int32_t cx0 = Cell(min_x), cx1 = Cell(max_x);
+    int32_t cy0 = Cell(min_y), cy1 = Cell(max_y);
+    double cells = ((double) cx1 - cx0 + 1)*((double) cy1 - cy0 + 1);
+    if (cells > head_.size()){
+        for (int i = 0; i < (int) used_.size(); i++){
+            if (used_[i]){
+                visit(i);
+            }
+        }
+        return;
+    }
+
+    for (int64_t cx = cx0; cx <= cx1; cx++){
+        for (int64_t cy = cy0; cy <= cy1; cy++){
+            std::unordered_map<uint64_t, int>::const_iterator it = head_.find(Key((int32_t) cx, (int32_t) cy));
+            if (it == head_.end()){
+                continue;
+            }
+            for (int i = it->second; i != -1; i = next_[i]){
+                visit(i);
+            }
+        }
+    }
+}
+
+} // namespace game
+
+#endif // SPATIAL_INDEX_H_
@@ -2,6 +2,7 @@
 #include <string>
 #include <glm/gtc/type_ptr.hpp>
 
+#include "gl_state.h"
 #include "sprite.h"
 
 namespace game {
@@ -38,7 +39,9 @@ void Sprite::CreateGeometry(void){
         2, 3, 0  // t2
     };
 
-    // Create buffer for vertices
+    // Create buffer for vertices, outside of any vertex array so that the
+    // index buffer binding does not change one
+    GLState::BindVertexArray(0);
     glGenBuffers(1, &vbo_);
     glBindBuffer(GL_ARRAY_BUFFER, vbo_);
     glBufferData(GL_ARRAY_BUFFER, sizeof(vertex), vertex, GL_STATIC_DRAW);
@@ -53,31 +56,22 @@ void Sprite::CreateGeometry(void){
 }
 
 
-void Sprite::SetGeometry(GLuint shader_program)
+void Sprite::SetState(void)
 {
 
     // No blending
-    glEnable(GL_DEPTH_TEST);
-    glDepthFunc(GL_LESS);
-    glDisable(GL_BLEND);
+    GLState::EnableDepthTest(GL_LESS);
+    GLState::DisableBlend();
+}
 
-    // Bind buffers
-    glBindBuffer(GL_ARRAY_BUFFER, vbo_);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo_);
 
-    // Set attributes for shaders
-    // Should be consistent with how we created the buffers for the square
-    GLint vertex_att = glGetAttribLocation(shader_program, "vertex");
-    glVertexAttribPointer(vertex_att, 2, GL_FLOAT, GL_FALSE, 7 * sizeof(GLfloat), 0);
-    glEnableVertexAttribArray(vertex_att);
-
-    GLint color_att = glGetAttribLocation(shader_program, "color");
-    glVertexAttribPointer(color_att, 3, GL_FLOAT, GL_FALSE, 7 * sizeof(GLfloat), (void *)(2 * sizeof(GLfloat)));
-    glEnableVertexAttribArray(color_att);
+void Sprite::SetAttributes(const Shader *shader)
+{
 
-    GLint tex_att = glGetAttribLocation(shader_program, "uv");
-    glVertexAttribPointer(tex_att, 2, GL_FLOAT, GL_FALSE, 7 * sizeof(GLfloat), (void *)(5 * sizeof(GLfloat)));
-    glEnableVertexAttribArray(tex_att);
+    // Should be consistent with how we created the buffers for the square
+    SetAttribute(shader, "vertex", 2, 7, 0);
+    SetAttribute(shader, "color", 3, 7, 2);
+    SetAttribute(shader, "uv", 2, 7, 5);
 }
 
 } // namespace game
@@ -15,8 +15,12 @@ namespace game {
             // Create the geometry (called once)
             void CreateGeometry(void);
 
-            // Use the geometry
-            void SetGeometry(GLuint shader_program);
+            // Draw with depth test and without blending
+            void SetState(void);
+
+        protected:
+            // Set the attributes of the square
+            void SetAttributes(const Shader *shader);
 
     }; // class Sprite
 } // namespace game
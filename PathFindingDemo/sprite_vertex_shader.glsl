@@ -1,5 +1,6 @@
 // Source code of vertex shader
 #version 130
+#extension GL_ARB_uniform_buffer_object : require
 
 // Vertex buffer
 in vec2 vertex;
@@ -8,7 +9,11 @@ in vec2 uv;
 
 // Uniform (global) buffer
 uniform mat4 transformation_matrix;
-uniform mat4 view_matrix;
+// Per-frame constants, shared by all shaders
+layout(std140) uniform FrameData {
+    mat4 view_matrix;
+    float time;
+};
 
 // Attributes forwarded to the fragment shader
 out vec4 color_interp;
@@ -0,0 +1,108 @@
+#include "thread_pool.h"
+
+namespace game {
+
+ThreadPool::ThreadPool(int num_threads){
+
+    task_ = NULL;
+    count_ = 0;
+    next_ = 0;
+    batch_ = 0;
+    num_busy_ = 0;
+    stop_ = false;
+
+    if (num_threads <= 0){
+        num_threads = std::thread::hardware_concurrency();
+        if (num_threads <= 0){
+            num_threads = 1;
+        }
+    }
+    for (int i = 0; i < num_threads; i++){
+        thread_.push_back(std::thread(&ThreadPool::Work, this, i));
+    }
+}
+
+
+ThreadPool::~ThreadPool(){
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    start_.notify_all();
+    for (size_t i = 0; i < thread_.size(); i++){
+        thread_[i].join();
+    }
+}
+
+
+void ThreadPool::Run(int count, const std::function<void(int, int)> &task){
+
+    if (count <= 0){
+        return;
+    }
+
+    // Publish the batch and wake up the workers
+    std::unique_lock<std::mutex> lock(mutex_);
+    task_ = &task;
+    count_ = count;
+    next_ = 0;
+    num_busy_ = thread_.size();
+    batch_++;
+    start_.notify_all();
+
+    // Wait until every worker is done with the batch
+    done_.wait(lock, [this]{ return num_busy_ == 0; });
+    task_ = NULL;
+
+    // Pass on the error of a failed task
+    if (error_){
+        std::exception_ptr error = error_;
+        error_ = NULL;
+        std::rethrow_exception(error);
+    }
+}
+
+
+void ThreadPool::Work(int index){
+
+    unsigned int batch = 0;
+    while (true){
+        // Wait for a new batch
+        const std::function<void(int, int)> *task;
+        int count;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            start_.wait(lock, [this, batch]{ return stop_ || batch_ != batch; });
+            if (stop_){
+                return;
+            }
+            batch = batch_;
+            task = task_;
+            count = count_;
+        }
+
+        // Take tasks until there are none left
+        try {
+            for (int i = next_++; i < count; i = next_++){
+                (*task)(i, index);
+            }
+        } catch (...) {
+            // Keep the first error and skip the remaining tasks
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!error_){
+                error_ = std::current_exception();
+            }
+            next_ = count;
+        }
+
+        // Let Run return once the last worker is done
+        std::lock_guard<std::mutex> lock(mutex_);
+        num_busy_--;
+        if (num_busy_ == 0){
+            done_.notify_one();
+        }
+    }
+}
+
+} // namespace game
@@ -0,0 +1,78 @@
+#ifndef THREAD_POOL_H_
+#define THREAD_POOL_H_
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <exception>
+
+namespace game {
+
+// A fixed set of worker threads that run batches of independent tasks
+//
+// The threads are created once and sleep between batches, so a batch
+// costs no thread creation. Tasks are handed out one at a time from a
+// shared counter, so threads that get short tasks simply take more of
+// them
+class ThreadPool {
+
+    public:
+        // Start the given number of worker threads, or one per hardware
+        // thread if num_threads is 0
+        ThreadPool(int num_threads = 0);
+
+        // Stop and join all the threads
+        ~ThreadPool();
+
+        // Get the number of worker threads
+        inline int GetNumThreads(void) const { return thread_.size(); }
+
+        // Call task(index, thread) for every index from 0 to count-1,
+        // where thread is the index of the worker running the task, and
+        // return once all the calls are done
+        // If a task throws, no more tasks are started and the exception
+        // is thrown again here. Batches cannot be run from several
+        // threads at once
+        void Run(int count, const std::function<void(int, int)> &task);
+
+        // A pool owns its threads, so it cannot be copied
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+    private:
+        // Worker threads
+        std::vector<std::thread> thread_;
+
+        // Lock and signals protecting the state of the current batch
+        std::mutex mutex_;
+        std::condition_variable start_;
+        std::condition_variable done_;
+
+        // Current batch: task to run, number of tasks, and index of the
+        // next task to hand out
+        const std::function<void(int, int)> *task_;
+        int count_;
+        std::atomic<int> next_;
+
+        // Number of the current batch, so that workers notice new ones
+        unsigned int batch_;
+
+        // Number of workers still running tasks of the current batch
+        int num_busy_;
+
+        // First exception thrown by a task of the current batch
+        std::exception_ptr error_;
+
+        // Flag telling the workers to exit
+        bool stop_;
+
+        // Main loop of worker thread number index
+        void Work(int index);
+};
+
+} // namespace game
+
+#endif // THREAD_POOL_H_